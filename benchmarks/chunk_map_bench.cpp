@@ -0,0 +1,154 @@
+// Micro-benchmark: World's old std::map chunk index vs ChunkMap.
+// Standalone, only needs the header:
+//   g++ -O2 -std=c++20 -I.. chunk_map_bench.cpp -o chunk_map_bench
+//   cl /O2 /std:c++20 /I.. chunk_map_bench.cpp
+
+#include <map>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <iostream>
+#include <iomanip>
+
+#include "chunk_map.hpp"
+
+using Clock = std::chrono::high_resolution_clock;
+
+const int RENDER_DISTANCE = 16; // 33 x 33 = 1089 loaded chunks, like World's default
+const int GRID = RENDER_DISTANCE * 2 + 1;
+
+// Keeps the optimizer from throwing the lookups away
+volatile long long sink = 0;
+
+template <typename F>
+double nsPerOp(long long ops, F&& body) {
+    auto start = Clock::now();
+    body();
+    auto end = Clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / (double)ops;
+}
+
+void report(const char* name, double mapNs, double hashNs) {
+    std::cout << std::left << std::setw(34) << name
+        << std::right << std::fixed << std::setprecision(2)
+        << std::setw(10) << mapNs << " ns"
+        << std::setw(10) << hashNs << " ns"
+        << std::setw(9) << mapNs / hashNs << "x" << std::endl;
+}
+
+int main() {
+    std::map<std::pair<int, int>, int*> tree;
+    ChunkMap<int*> hash;
+    std::vector<int> payload(GRID * GRID);
+
+    for (int x = -RENDER_DISTANCE; x <= RENDER_DISTANCE; x++) {
+        for (int z = -RENDER_DISTANCE; z <= RENDER_DISTANCE; z++) {
+            int* value = &payload[(x + RENDER_DISTANCE) * GRID + (z + RENDER_DISTANCE)];
+            tree[{x, z}] = value;
+            hash.insert(x, z, value);
+        }
+    }
+
+    std::cout << "Chunks loaded: " << hash.size() << "\n\n";
+    std::cout << std::left << std::setw(34) << "" << std::right
+        << std::setw(13) << "std::map" << std::setw(13) << "ChunkMap" << std::setw(10) << "speedup" << "\n";
+
+    // 1. World::update: check every cell of the load square, every frame
+    {
+        const int frames = 2000;
+        const long long ops = (long long)frames * GRID * GRID;
+        double mapNs = nsPerOp(ops, [&] {
+            long long found = 0;
+            for (int f = 0; f < frames; f++)
+                for (int x = -RENDER_DISTANCE; x <= RENDER_DISTANCE; x++)
+                    for (int z = -RENDER_DISTANCE; z <= RENDER_DISTANCE; z++)
+                        found += tree.find({ x, z }) != tree.end();
+            sink = sink + found;
+        });
+        double hashNs = nsPerOp(ops, [&] {
+            long long found = 0;
+            for (int f = 0; f < frames; f++)
+                for (int x = -RENDER_DISTANCE; x <= RENDER_DISTANCE; x++)
+                    for (int z = -RENDER_DISTANCE; z <= RENDER_DISTANCE; z++)
+                        found += hash.contains(x, z);
+            sink = sink + found;
+        });
+        report("update() load-square scan", mapNs, hashNs);
+    }
+
+    // 2. World::getBlock at random positions (old code: find + operator[])
+    {
+        const int lookups = 4000000;
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> coord(-RENDER_DISTANCE - 2, RENDER_DISTANCE + 2);
+        std::vector<std::pair<int, int>> keys(lookups);
+        for (auto& k : keys) k = { coord(rng), coord(rng) };
+
+        double mapNs = nsPerOp(lookups, [&] {
+            long long total = 0;
+            for (auto& k : keys) {
+                if (tree.find(k) != tree.end()) total += *tree[k];
+            }
+            sink = sink + total;
+        });
+        double hashNs = nsPerOp(lookups, [&] {
+            long long total = 0;
+            for (auto& k : keys) {
+                if (int** v = hash.find(k.first, k.second)) total += **v;
+            }
+            sink = sink + total;
+        });
+        report("getBlock() random chunks", mapNs, hashNs);
+    }
+
+    // 3. Coherent access, like raycast/checkCollision: long runs in the same chunk
+    {
+        const int lookups = 4000000;
+        double mapNs = nsPerOp(lookups, [&] {
+            long long total = 0;
+            for (int i = 0; i < lookups; i++) {
+                std::pair<int, int> k = { (i / 256) % GRID - RENDER_DISTANCE, (i / 4096) % GRID - RENDER_DISTANCE };
+                if (tree.find(k) != tree.end()) total += *tree[k];
+            }
+            sink = sink + total;
+        });
+        double hashNs = nsPerOp(lookups, [&] {
+            long long total = 0;
+            for (int i = 0; i < lookups; i++) {
+                int x = (i / 256) % GRID - RENDER_DISTANCE, z = (i / 4096) % GRID - RENDER_DISTANCE;
+                if (int** v = hash.find(x, z)) total += **v;
+            }
+            sink = sink + total;
+        });
+        report("getBlock() coherent walk", mapNs, hashNs);
+    }
+
+    // 4. Moving one chunk along X: insert a new row, erase the old one
+    {
+        const int steps = 2000;
+        std::map<std::pair<int, int>, int*> treeCopy = tree;
+        ChunkMap<int*> hashCopy = hash;
+        const long long ops = (long long)steps * GRID * 2;
+
+        double mapNs = nsPerOp(ops, [&] {
+            for (int s = 0; s < steps; s++) {
+                for (int z = -RENDER_DISTANCE; z <= RENDER_DISTANCE; z++) {
+                    treeCopy[{ s + RENDER_DISTANCE + 1, z }] = payload.data();
+                    treeCopy.erase({ s - RENDER_DISTANCE, z });
+                }
+            }
+        });
+        double hashNs = nsPerOp(ops, [&] {
+            for (int s = 0; s < steps; s++) {
+                for (int z = -RENDER_DISTANCE; z <= RENDER_DISTANCE; z++) {
+                    hashCopy.insert(s + RENDER_DISTANCE + 1, z, payload.data());
+                    hashCopy.erase(s - RENDER_DISTANCE, z);
+                }
+            }
+        });
+        report("load/unload a row (per op)", mapNs, hashNs);
+        sink = sink + (long long)treeCopy.size() + (long long)hashCopy.size();
+    }
+
+    return 0;
+}
@@ -0,0 +1,129 @@
+// Micro-benchmark: terrain noise per chunk, stb_perlin_noise3 one column at a time
+// (what Chunk::generateBlocks used to do) vs batched TerrainNoise.
+// Needs stb_perlin.h on the include path; build with AVX2 to get the 8-wide kernel:
+//   g++ -O2 -mavx2 -std=c++20 -I.. noise_bench.cpp -o noise_bench
+//   cl /O2 /arch:AVX2 /std:c++20 /I.. noise_bench.cpp
+
+#define STB_PERLIN_IMPLEMENTATION
+#include "stb_perlin.h"
+
+#include <cmath>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+#include "terrain_noise.hpp"
+
+using Clock = std::chrono::high_resolution_clock;
+
+const int CHUNK_SIZE = 16;
+const int COLUMNS = CHUNK_SIZE * CHUNK_SIZE;
+const int OCTAVES = 4;
+const int RENDER_DISTANCE = 16; // 33 x 33 chunks, a full spawn area at the default distance
+const int GRID = RENDER_DISTANCE * 2 + 1;
+
+// Same seed and octaves as Chunk::generateBlocks
+const float SEED = 1234.0f;
+const float SCALES[OCTAVES] = { 0.02f, 0.05f, 0.1f, 0.008f };
+const float AMPS[OCTAVES] = { 6.0f, 3.0f, 1.0f, 150.0f };
+const float RANGE_THRESHOLD = 0.3f; // The last octave only counts above this
+
+volatile float sink = 0;
+
+// Height of every column of chunk (cx, cz), as generateBlocks computes it
+void heightsStb(int cx, int cz, int* heights) {
+    for (int i = 0; i < COLUMNS; i++) {
+        float worldX = (float)(cx * CHUNK_SIZE + i / CHUNK_SIZE);
+        float worldZ = (float)(cz * CHUNK_SIZE + i % CHUNK_SIZE);
+        float h = 0;
+        for (int o = 0; o < OCTAVES; o++) {
+            float n = stb_perlin_noise3((worldX + SEED) * SCALES[o], (worldZ + SEED) * SCALES[o], 0, 0, 0, 0);
+            h += (o == 3 ? std::max(0.0f, n - RANGE_THRESHOLD) : n) * AMPS[o];
+        }
+        heights[i] = 3 + (int)h;
+    }
+}
+
+void heightsBatched(int cx, int cz, int* heights) {
+    float noise[OCTAVES][COLUMNS], xs[COLUMNS], zs[COLUMNS];
+    for (int o = 0; o < OCTAVES; o++) {
+        for (int i = 0; i < COLUMNS; i++) {
+            xs[i] = ((float)(cx * CHUNK_SIZE + i / CHUNK_SIZE) + SEED) * SCALES[o];
+            zs[i] = ((float)(cz * CHUNK_SIZE + i % CHUNK_SIZE) + SEED) * SCALES[o];
+        }
+        TerrainNoise::noise2(xs, zs, noise[o], COLUMNS);
+    }
+    for (int i = 0; i < COLUMNS; i++) {
+        float h = noise[0][i] * AMPS[0] + noise[1][i] * AMPS[1] + noise[2][i] * AMPS[2];
+        h += std::max(0.0f, noise[3][i] - RANGE_THRESHOLD) * AMPS[3];
+        heights[i] = 3 + (int)h;
+    }
+}
+
+template <typename F>
+double usPerChunk(F&& heightsOf) {
+    int heights[COLUMNS];
+    auto start = Clock::now();
+    for (int x = -RENDER_DISTANCE; x <= RENDER_DISTANCE; x++) {
+        for (int z = -RENDER_DISTANCE; z <= RENDER_DISTANCE; z++) {
+            heightsOf(x, z, heights);
+            sink = sink + (float)heights[x & 255];
+        }
+    }
+    auto end = Clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / (GRID * GRID);
+}
+
+int main() {
+#if defined(TERRAIN_NOISE_AVX2)
+    const char* kernel = "AVX2, 8 wide";
+#elif defined(TERRAIN_NOISE_SSE2)
+    const char* kernel = "SSE2, 4 wide";
+#else
+    const char* kernel = "scalar";
+#endif
+
+    // The gradient table is read back from stb once, on first use
+    auto start = Clock::now();
+    sink = sink + TerrainNoise::noise2(0.5f, 0.5f);
+    double setupMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    // Accuracy over the whole area, raw noise and resulting block heights
+    float maxError = 0;
+    long long heightMismatches = 0;
+    for (int x = -RENDER_DISTANCE; x <= RENDER_DISTANCE; x++) {
+        for (int z = -RENDER_DISTANCE; z <= RENDER_DISTANCE; z++) {
+            int a[COLUMNS], b[COLUMNS];
+            heightsStb(x, z, a);
+            heightsBatched(x, z, b);
+            for (int i = 0; i < COLUMNS; i++) heightMismatches += a[i] != b[i];
+
+            for (int o = 0; o < OCTAVES; o++) {
+                float xs[COLUMNS], zs[COLUMNS], batched[COLUMNS];
+                for (int i = 0; i < COLUMNS; i++) {
+                    xs[i] = ((float)(x * CHUNK_SIZE + i / CHUNK_SIZE) + SEED) * SCALES[o];
+                    zs[i] = ((float)(z * CHUNK_SIZE + i % CHUNK_SIZE) + SEED) * SCALES[o];
+                }
+                TerrainNoise::noise2(xs, zs, batched, COLUMNS);
+                for (int i = 0; i < COLUMNS; i++) {
+                    maxError = std::max(maxError, std::fabs(batched[i] - stb_perlin_noise3(xs[i], zs[i], 0, 0, 0, 0)));
+                }
+            }
+        }
+    }
+
+    double stbUs = usPerChunk(heightsStb);
+    double batchedUs = usPerChunk(heightsBatched);
+
+    std::cout << "Kernel: " << kernel << ", " << GRID * GRID << " chunks, "
+        << OCTAVES << " octaves x " << COLUMNS << " columns per chunk\n";
+    std::cout << std::fixed << std::setprecision(2)
+        << "Gradient table setup:   " << setupMs << " ms (once)\n"
+        << "stb_perlin_noise3:      " << stbUs << " us/chunk\n"
+        << "TerrainNoise::noise2:   " << batchedUs << " us/chunk (" << stbUs / batchedUs << "x)\n"
+        << std::scientific << std::setprecision(2)
+        << "Max noise difference:   " << maxError << "\n"
+        << "Column heights differing: " << heightMismatches << " of " << (long long)GRID * GRID * COLUMNS << std::endl;
+    return 0;
+}
@@ -0,0 +1,445 @@
+// Micro-benchmarks for the voxel core's hot paths: terrain generation, meshing (CPU
+// side), World::getBlock, raycast, checkCollision and the chunk save/load round trip.
+// Reports ns/op, heap bytes and allocations per op, and vertices/faces for meshing.
+// Built by CMake as voxel_bench (needs the core library), or:
+//   g++ -O2 -std=c++20 -I.. voxel_bench.cpp ../block_manager.cpp ../stb_perlin.cpp -pthread -o voxel_bench
+// Run it from the repository root so it finds blocks.json:
+//   voxel_bench [--filter text] [--json results.json] [--baseline results.json] [--threshold percent]
+// --json writes the results, --baseline compares against a file written that way and
+// exits with 1 if anything got slower / allocates more / produces more vertices than
+// the threshold allows (default 10%).
+
+#include <new>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <filesystem>
+#include <nlohmann/json.hpp>
+
+#include "world.hpp"
+#include "physics.hpp"
+
+using Clock = std::chrono::steady_clock;
+using json = nlohmann::json;
+
+// === Allocation counting ===
+// Every heap allocation made by the thread running a benchmark. Thread local, so the
+// workers of the World in the background don't count.
+thread_local long long allocatedBytes = 0;
+thread_local long long allocationCount = 0;
+
+// All the forms a new/delete pair can use, so that every pair ends up in the same
+// malloc/free
+void* countedAlloc(size_t size) {
+    allocatedBytes += size;
+    allocationCount++;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size) { return countedAlloc(size); }
+void* operator new[](size_t size) { return countedAlloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+// === Harness ===
+// Timed runs per benchmark, after one untimed warm-up run. The fastest is reported:
+// other work on the machine only ever adds time.
+const int REPEATS = 5;
+const char* BENCH_FOLDER = "bench_saves/";
+
+// Keeps the optimizer from throwing the results away
+volatile long long sink = 0;
+
+struct Result {
+    std::string name;
+    double nsPerOp = 0.0;
+    double bytesPerOp = 0.0;
+    double allocsPerOp = 0.0;
+    double verticesPerOp = -1.0; // -1 = doesn't produce any
+    double facesPerOp = -1.0;
+};
+
+// What one run of a benchmark did: how many ops, and the vertices they produced
+struct Work {
+    long long ops = 0;
+    long long vertices = -1;
+};
+
+std::string filter;
+std::vector<Result> results;
+
+// setup() runs before every timed run, neither timed nor counted. body() does the ops.
+template <typename Setup, typename Body>
+void run(const std::string& name, Setup&& setup, Body&& body) {
+    if (!filter.empty() && name.find(filter) == std::string::npos) return;
+
+    std::vector<double> times;
+    Result r;
+    r.name = name;
+    for (int i = 0; i <= REPEATS; i++) {
+        setup();
+        long long bytesBefore = allocatedBytes, countBefore = allocationCount;
+        auto start = Clock::now();
+        Work work = body();
+        auto end = Clock::now();
+
+        double ops = (double)std::max(work.ops, 1LL);
+        if (i == 0) continue; // Warm-up
+        times.push_back(std::chrono::duration<double, std::nano>(end - start).count() / ops);
+        // Allocations from the repeat that made the most, so nothing that only shows
+        // up in some runs is missed
+        r.bytesPerOp = std::max(r.bytesPerOp, (allocatedBytes - bytesBefore) / ops);
+        r.allocsPerOp = std::max(r.allocsPerOp, (allocationCount - countBefore) / ops);
+        if (work.vertices >= 0) {
+            r.verticesPerOp = work.vertices / ops;
+            r.facesPerOp = work.vertices / 4 / ops; // Every face is one quad
+        }
+    }
+    r.nsPerOp = *std::min_element(times.begin(), times.end());
+    results.push_back(r);
+
+    std::cout << std::left << std::setw(34) << name << std::right << std::fixed
+        << std::setprecision(1) << std::setw(13) << r.nsPerOp
+        << std::setw(13) << r.bytesPerOp
+        << std::setprecision(2) << std::setw(10) << r.allocsPerOp;
+    if (r.verticesPerOp >= 0) {
+        std::cout << std::setprecision(1) << std::setw(11) << r.verticesPerOp << std::setw(10) << r.facesPerOp;
+    }
+    std::cout << std::endl;
+}
+
+template <typename Body>
+void run(const std::string& name, Body&& body) {
+    run(name, [] {}, body);
+}
+
+// === Baseline ===
+bool writeResults(const std::string& path) {
+    json out;
+    for (const Result& r : results) {
+        json& entry = out["benchmarks"][r.name];
+        entry["ns_per_op"] = r.nsPerOp;
+        entry["bytes_per_op"] = r.bytesPerOp;
+        entry["allocs_per_op"] = r.allocsPerOp;
+        if (r.verticesPerOp >= 0) {
+            entry["vertices_per_op"] = r.verticesPerOp;
+            entry["faces_per_op"] = r.facesPerOp;
+        }
+    }
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Can't write " << path << std::endl;
+        return false;
+    }
+    file << out.dump(2) << std::endl;
+    std::cout << "Wrote " << results.size() << " results to " << path << std::endl;
+    return true;
+}
+
+// Lower is better for everything compared. Returns the number of regressions (-1 if
+// the baseline can't be read).
+int compareBaseline(const std::string& path, double thresholdPercent) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Can't read baseline " << path << std::endl;
+        return -1;
+    }
+    json baseline = json::parse(file, nullptr, false);
+    if (baseline.is_discarded() || !baseline.contains("benchmarks")) {
+        std::cerr << "Not a benchmark baseline: " << path << std::endl;
+        return -1;
+    }
+
+    std::cout << "\nAgainst " << path << " (threshold " << thresholdPercent << "%)" << std::endl;
+    int regressions = 0;
+    const double limit = 1.0 + thresholdPercent / 100.0;
+    for (const Result& r : results) {
+        if (!baseline["benchmarks"].contains(r.name)) {
+            std::cout << std::left << std::setw(34) << r.name << "not in baseline" << std::endl;
+            continue;
+        }
+        const json& base = baseline["benchmarks"][r.name];
+
+        std::string verdict;
+        // Above the baseline by more than the threshold, plus `slack` in absolute terms.
+        // The slack covers one-off allocations spread over the ops; growth from zero
+        // past it still counts. Time is relative only.
+        auto check = [&](const char* key, double current, double slack) {
+            if (current < 0 || !base.contains(key)) return;
+            double before = base[key];
+            if (current > before * limit + slack) {
+                char line[128];
+                snprintf(line, sizeof(line), " %s %.2f -> %.2f", key, before, current);
+                verdict += line;
+            }
+        };
+        check("ns_per_op", r.nsPerOp, 0.0);
+        check("bytes_per_op", r.bytesPerOp, 0.5);
+        check("allocs_per_op", r.allocsPerOp, 0.05);
+        check("vertices_per_op", r.verticesPerOp, 0.5);
+
+        double speedup = r.nsPerOp > 0.0 ? (double)base["ns_per_op"] / r.nsPerOp : 0.0;
+        std::cout << std::left << std::setw(34) << r.name << std::right << std::fixed
+            << std::setprecision(2) << std::setw(7) << speedup << "x";
+        if (!verdict.empty()) {
+            std::cout << "  REGRESSION" << verdict;
+            regressions++;
+        }
+        std::cout << std::endl;
+    }
+    return regressions;
+}
+
+// === Benchmarks ===
+const int AREA_RADIUS = 6; // Chunks around the origin that the World benchmarks use
+const int AREA_BLOCKS = AREA_RADIUS * CHUNK_SIZE;
+
+// Streams in the chunks around the origin and waits until the workers are done, so
+// they don't compete with the benchmarks
+bool loadArea(World& world) {
+    auto start = Clock::now();
+    int idleFrames = 0;
+    while (Clock::now() - start < std::chrono::seconds(60)) {
+        world.update(glm::vec3(8.0f, 40.0f, 8.0f));
+
+        bool loaded = world.queuedJobs() == 0;
+        for (int cx = -AREA_RADIUS; cx <= AREA_RADIUS && loaded; cx++) {
+            for (int cz = -AREA_RADIUS; cz <= AREA_RADIUS && loaded; cz++) {
+                loaded = world.findChunk(cx, cz) != nullptr;
+            }
+        }
+        // Jobs already taken by a worker aren't queued any more, give them a moment
+        idleFrames = loaded ? idleFrames + 1 : 0;
+        if (idleFrames == 50) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    return false;
+}
+
+void benchGenerateBlocks() {
+    // Chunks far from the World's, new ones for every run so no storage is reused
+    const int GRID = 16;
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    run("Chunk::generateBlocks", [&] {
+        chunks.clear();
+        for (int i = 0; i < GRID * GRID; i++) {
+            chunks.push_back(std::make_unique<Chunk>(1000 + i / GRID, 1000 + i % GRID));
+        }
+    }, [&] {
+        for (auto& c : chunks) c->generateBlocks();
+        return Work{ (long long)chunks.size() };
+    });
+}
+
+void benchGenerateMesh(World& world) {
+    // Every section of the area that World would mesh, with its borders gathered up front
+    struct Job {
+        Chunk* chunk;
+        int section;
+        ChunkBorders borders;
+    };
+    std::vector<Job> jobs;
+    for (int cx = -AREA_RADIUS; cx <= AREA_RADIUS; cx++) {
+        for (int cz = -AREA_RADIUS; cz <= AREA_RADIUS; cz++) {
+            Chunk* c = world.findChunk(cx, cz);
+            for (int section = 0; section < CHUNK_SECTIONS; section++) {
+                if (world.isHiddenSection(c, section)) continue;
+                jobs.push_back({ c, section, world.gatherBorders(cx, section, cz) });
+            }
+        }
+    }
+
+    MeshUploader uploader; // Counts only
+    auto body = [&] {
+        long long vertices = 0;
+        for (Job& job : jobs) {
+            job.chunk->generateMesh(job.section, job.borders, uploader);
+            vertices += job.chunk->meshes[job.section].vertexCount;
+        }
+        return Work{ (long long)jobs.size(), vertices };
+    };
+
+    Chunk::meshingMode = MeshingMode::Greedy;
+    run("Chunk::generateMesh (greedy)", body);
+    Chunk::meshingMode = MeshingMode::Naive;
+    run("Chunk::generateMesh (naive)", body);
+    Chunk::meshingMode = MeshingMode::Greedy;
+}
+
+void benchGetBlock(World& world) {
+    const int COUNT = 1 << 20;
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> horizontal(-AREA_BLOCKS, AREA_BLOCKS + CHUNK_SIZE - 1);
+    std::uniform_int_distribution<int> vertical(0, WORLD_HEIGHT - 1);
+    std::vector<glm::ivec3> positions(COUNT);
+    for (glm::ivec3& p : positions) p = glm::ivec3(horizontal(rng), vertical(rng), horizontal(rng));
+
+    run("World::getBlock (random)", [&] {
+        long long sum = 0;
+        for (const glm::ivec3& p : positions) sum += world.getBlock(p.x, p.y, p.z);
+        sink = sink + sum;
+        return Work{ COUNT };
+    });
+
+    // Column by column, bottom to top, like a scan over the area
+    run("World::getBlock (coherent)", [&] {
+        long long sum = 0, ops = 0;
+        for (int x = -AREA_BLOCKS; x < AREA_BLOCKS; x++) {
+            for (int z = -AREA_BLOCKS; z < AREA_BLOCKS; z++) {
+                for (int y = 0; y < WORLD_HEIGHT; y++) {
+                    sum += world.getBlock(x, y, z);
+                }
+                ops += WORLD_HEIGHT;
+            }
+        }
+        sink = sink + sum;
+        return Work{ ops };
+    });
+}
+
+void benchRaycast(World& world) {
+    // From random points above the ground, in random directions (mostly downwards)
+    const int COUNT = 1 << 14;
+    std::mt19937 rng(5678);
+    std::uniform_real_distribution<float> horizontal(-(float)AREA_BLOCKS + 64.0f, (float)AREA_BLOCKS - 64.0f);
+    std::uniform_real_distribution<float> height(20.0f, 60.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<std::pair<glm::vec3, glm::vec3>> rays(COUNT);
+    for (auto& [start, dir] : rays) {
+        start = glm::vec3(horizontal(rng), height(rng), horizontal(rng));
+        dir = glm::vec3(unit(rng), unit(rng) - 0.5f, unit(rng));
+    }
+
+    for (float range : { 8.0f, 64.0f }) {
+        run("raycast (" + std::to_string((int)range) + " blocks)", [&] {
+            long long hits = 0;
+            for (auto& [start, dir] : rays) hits += raycast(world, start, dir, range).hit;
+            sink = sink + hits;
+            return Work{ COUNT };
+        });
+    }
+}
+
+void benchCheckCollision(World& world) {
+    // Player-sized boxes around the surface, some in the air and some in the ground
+    const int COUNT = 1 << 16;
+    std::mt19937 rng(9012);
+    std::uniform_real_distribution<float> horizontal(-(float)AREA_BLOCKS, (float)AREA_BLOCKS);
+    std::uniform_real_distribution<float> height(0.0f, 64.0f);
+    std::vector<glm::vec3> positions(COUNT);
+    for (glm::vec3& p : positions) p = glm::vec3(horizontal(rng), height(rng), horizontal(rng));
+
+    run("checkCollision", [&] {
+        long long hits = 0;
+        for (const glm::vec3& p : positions) hits += checkCollision(world, p, 0.6f, 1.8f);
+        sink = sink + hits;
+        return Work{ COUNT };
+    });
+}
+
+void benchSaveLoad(World& world) {
+    // The steps of World::writeChunkFile and World::loadChunk, on this thread and
+    // without the save queue: blocks -> encodeColumn -> region file and back
+    std::string folder = std::string(BENCH_FOLDER) + "regions/";
+    fs::create_directories(folder);
+    RegionStore regions(folder);
+
+    std::vector<Chunk*> chunks;
+    for (int cx = -AREA_RADIUS; cx <= AREA_RADIUS; cx++) {
+        for (int cz = -AREA_RADIUS; cz <= AREA_RADIUS; cz++) {
+            chunks.push_back(world.findChunk(cx, cz));
+        }
+    }
+
+    run("saveChunk (encode + write)", [&] {
+        std::vector<uint8_t> blocks((size_t)CHUNK_SECTIONS * BlockStorage::VOLUME);
+        std::vector<uint8_t> encoded;
+        for (Chunk* c : chunks) {
+            c->copyBlocks(blocks.data());
+            encodeColumn(blocks.data(), CHUNK_SECTIONS, encoded);
+            regions.write(c->x, c->z, encoded.data(), encoded.size());
+        }
+        return Work{ (long long)chunks.size() };
+    });
+
+    Chunk loaded(0, 0);
+    run("loadChunk (read + decode)", [&] {
+        std::vector<uint8_t> data;
+        std::vector<uint8_t> decoded((size_t)CHUNK_SECTIONS * CHUNK_CODEC_VOLUME);
+        long long ok = 0;
+        for (Chunk* c : chunks) {
+            if (!regions.read(c->x, c->z, data)) continue;
+            if (!decodeColumn(data.data(), data.size(), decoded.data(), CHUNK_SECTIONS)) continue;
+            loaded.loadBlocks(decoded.data());
+            ok++;
+        }
+        sink = sink + ok;
+        return Work{ (long long)chunks.size() };
+    });
+}
+
+int main(int argc, char** argv) {
+    std::string jsonPath, baselinePath;
+    double threshold = 10.0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--filter" && hasValue) filter = argv[++i];
+        else if (arg == "--json" && hasValue) jsonPath = argv[++i];
+        else if (arg == "--baseline" && hasValue) baselinePath = argv[++i];
+        else if (arg == "--threshold" && hasValue) threshold = std::atof(argv[++i]);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--filter text] [--json results.json] [--baseline results.json] [--threshold percent]" << std::endl;
+            return 2;
+        }
+    }
+
+    globalBlockManager.loadBlocks("blocks.json");
+
+    // A world of its own, so nothing saved by the game gets loaded (or overwritten)
+    fs::remove_all(BENCH_FOLDER);
+    int failed = 0;
+    {
+        World world(std::string(BENCH_FOLDER) + "world/");
+        world.renderDistance = AREA_RADIUS + 1;
+        if (!loadArea(world)) {
+            std::cerr << "Timed out loading the benchmark area" << std::endl;
+            return 1;
+        }
+
+        std::cout << std::left << std::setw(34) << "benchmark" << std::right
+            << std::setw(13) << "ns/op" << std::setw(13) << "bytes/op" << std::setw(10) << "allocs/op"
+            << std::setw(11) << "verts/op" << std::setw(10) << "faces/op" << std::endl;
+
+        benchGenerateBlocks();
+        benchGenerateMesh(world);
+        benchGetBlock(world);
+        benchRaycast(world);
+        benchCheckCollision(world);
+        benchSaveLoad(world);
+
+        world.shutdown();
+    }
+    fs::remove_all(BENCH_FOLDER);
+
+    if (!jsonPath.empty() && !writeResults(jsonPath)) failed = 1;
+    if (!baselinePath.empty()) {
+        int regressions = compareBaseline(baselinePath, threshold);
+        if (regressions != 0) {
+            if (regressions > 0) std::cout << regressions << " regression(s)" << std::endl;
+            failed = 1;
+        }
+    }
+    return failed;
+}
@@ -1,13 +1,31 @@
 #include <fstream>
 #include <iostream>
-#include <glad/glad.h> 
-#include <GLFW/glfw3.h>
+#include <map>
 #include <nlohmann/json.hpp> 
 #include "block_manager.hpp"
-#include "stb_image.h"
 
 using json = nlohmann::json;
 
+BlockManager globalBlockManager;
+
+BlockManager::BlockManager() {
+    const uint8_t allFlags = BLOCK_FLAG_SOLID | BLOCK_FLAG_OPAQUE | BLOCK_FLAG_COLLIDABLE;
+    for (int id = 0; id < MAX_BLOCK_TYPES; id++) {
+        defineBlock(id, 0, 0, 0, id == 0 ? 0 : allFlags);
+    }
+}
+
+void BlockManager::defineBlock(int id, int topLayer, int bottomLayer, int sideLayer, uint8_t flags) {
+    BlockProperties& p = properties[id];
+    p = {};
+    p.faceLayers[0] = (uint16_t)topLayer;
+    p.faceLayers[1] = (uint16_t)bottomLayer;
+    for (int face = 2; face < 6; face++) {
+        p.faceLayers[face] = (uint16_t)sideLayer;
+    }
+    p.flags = flags;
+}
+
 void BlockManager::loadBlocks(const char* configPath) {
     std::ifstream f(configPath);
     if (!f.is_open()) {
@@ -16,13 +34,18 @@ void BlockManager::loadBlocks(const char* configPath) {
     }
 
     json data = json::parse(f);
-    std::vector<std::string> texturePaths;
+    texturePaths.clear();
     std::map<std::string, int> pathToIndex;
 
     // Process JSON
     for (auto& block : data) {
         int id = block["id"];
-        BlockFaceTextures faces;
+        if (id <= 0 || id >= MAX_BLOCK_TYPES) {
+            // 0 is air, and IDs are stored in one byte
+            std::cerr << "Block ID out of range in " << configPath << ": " << id << std::endl;
+            continue;
+        }
+        int top = 0, bottom = 0, side = 0;
 
         // Lambda to avoid duplicates
         auto registerTex = [&](std::string path) -> int {
@@ -34,62 +57,19 @@ void BlockManager::loadBlocks(const char* configPath) {
             };
 
         if (block.contains("texture") && block["texture"].is_string()) {
-            int idx = registerTex(block["texture"]);
-            faces = { idx, idx, idx };
+            top = bottom = side = registerTex(block["texture"]);
         }
         else if (block.contains("textures")) {
-            faces.topLayer = registerTex(block["textures"]["top"]);
-            faces.bottomLayer = registerTex(block["textures"]["bottom"]);
-            faces.sideLayer = registerTex(block["textures"]["side"]);
+            top = registerTex(block["textures"]["top"]);
+            bottom = registerTex(block["textures"]["bottom"]);
+            side = registerTex(block["textures"]["side"]);
         }
-        blockData[id] = faces;
-    }
-
-    // Generate OpenGL Texture Array
-    if (texturePaths.empty()) return;
-
-    glGenTextures(1, &textureArrayID);
-    glBindTexture(GL_TEXTURE_2D_ARRAY, textureArrayID);
-
-    // Load the first image to determine width/height for the whole array
-    int width, height, nrChannels;
-    std::string firstPath = "textures/" + texturePaths[0];
-    unsigned char* temp = stbi_load(firstPath.c_str(), &width, &height, &nrChannels, 0);
 
-    if (!temp) {
-        std::cerr << "Failed to load base texture: " << firstPath << std::endl;
-        return;
-    }
-    stbi_image_free(temp);
-
-    // Allocate the storage on GPU (width x height x NumberOfImages)
-    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, width, height, texturePaths.size(), 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
-
-    // Upload images to layers
-    for (int i = 0; i < texturePaths.size(); i++) {
-        std::string fullPath = "textures/" + texturePaths[i];
-        unsigned char* data = stbi_load(fullPath.c_str(), &width, &height, &nrChannels, 0);
-        if (data) {
-            GLenum format = (nrChannels == 4) ? GL_RGBA : GL_RGB;
-            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, width, height, 1, format, GL_UNSIGNED_BYTE, data);
-            stbi_image_free(data);
-        }
-        else {
-            std::cerr << "Failed to load texture layer: " << fullPath << std::endl;
-        }
+        // Optional flags, a plain block is all three
+        uint8_t flags = 0;
+        if (block.value("solid", true)) flags |= BLOCK_FLAG_SOLID;
+        if (block.value("opaque", true)) flags |= BLOCK_FLAG_OPAQUE;
+        if (block.value("collidable", true)) flags |= BLOCK_FLAG_COLLIDABLE;
+        defineBlock(id, top, bottom, side, flags);
     }
-
-    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
-
-    // Texture Parameters
-    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-    if (glfwExtensionSupported("GL_EXT_texture_filter_anisotropic")) {
-        float aniso = 0.0f;
-        glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &aniso);
-        glTexParameterf(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_ANISOTROPY, aniso);
-    }
-}
+}
\ No newline at end of file
@@ -1,24 +1,56 @@
 #pragma once
 
-#include <map>
+#include <cstdint>
 #include <string>
 #include <vector>
 
-// Stores which "layer" of the Texture Array corresponds to which face
-struct BlockFaceTextures {
-    int topLayer;
-    int bottomLayer;
-    int sideLayer;
+// Block IDs are one byte, so the property table covers every possible block
+const int MAX_BLOCK_TYPES = 256;
+
+// Per-block flags
+enum BlockFlag : uint8_t {
+    BLOCK_FLAG_SOLID = 1 << 0,      // Has faces to draw, and raycasts stop at it
+    BLOCK_FLAG_OPAQUE = 1 << 1,     // Hides the faces of the blocks next to it
+    BLOCK_FLAG_COLLIDABLE = 1 << 2  // The player can't walk through it
+};
+
+// Everything the hot loops need to know about a block type, 16 bytes so four share a
+// cache line. Face layers are in BlockFace order: top, bottom, front, back, left, right.
+struct alignas(16) BlockProperties {
+    uint16_t faceLayers[6];
+    uint8_t flags;
+
+    bool isSolid() const { return (flags & BLOCK_FLAG_SOLID) != 0; }
+    bool isOpaque() const { return (flags & BLOCK_FLAG_OPAQUE) != 0; }
+    bool isCollidable() const { return (flags & BLOCK_FLAG_COLLIDABLE) != 0; }
 };
+static_assert(sizeof(BlockProperties) == 16, "BlockProperties should stay 16 bytes");
 
 class BlockManager {
 public:
-    // Holds the data loaded from JSON: Block ID -> Texture Info
-    std::map<int, BlockFaceTextures> blockData;
+    // Block ID -> properties, indexed directly (no lookup, no misses). Filled from
+    // blocks.json by loadBlocks() and read-only after that, so worker threads can
+    // use it freely. ID 0 is air; IDs missing from the JSON stay solid blocks with
+    // texture layer 0, so unknown data shows up instead of leaving holes.
+    alignas(64) BlockProperties properties[MAX_BLOCK_TYPES];
 
-    // The OpenGL ID for the GL_TEXTURE_2D_ARRAY
-    unsigned int textureArrayID;
+    // Texture file of each texture array layer (under textures/), in layer order.
+    // Filled by loadBlocks(); the game turns it into a GL texture array with
+    // loadBlockTextureArray (block_textures.hpp).
+    std::vector<std::string> texturePaths;
+
+    BlockManager();
 
     // Call this once at startup
     void loadBlocks(const char* configPath);
+
+    // Sets up one block type, `flags` is a combination of BlockFlag
+    void defineBlock(int id, int topLayer, int bottomLayer, int sideLayer, uint8_t flags);
+
+    const BlockProperties& get(uint8_t id) const {
+        return properties[id];
+    }
 };
+
+// The block table everything reads (defined in block_manager.cpp)
+extern BlockManager globalBlockManager;
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "stb_image.h"
+
+// Builds the GL_TEXTURE_2D_ARRAY the block shaders sample, one layer per file in
+// `texturePaths` (BlockManager::texturePaths, relative to textures/). Every image must
+// have the size of the first one. Returns 0 if there is nothing to load.
+inline unsigned int loadBlockTextureArray(const std::vector<std::string>& texturePaths) {
+    if (texturePaths.empty()) return 0;
+
+    unsigned int textureArrayID = 0;
+    glGenTextures(1, &textureArrayID);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, textureArrayID);
+
+    // Load the first image to determine width/height for the whole array
+    int width, height, nrChannels;
+    std::string firstPath = "textures/" + texturePaths[0];
+    unsigned char* temp = stbi_load(firstPath.c_str(), &width, &height, &nrChannels, 0);
+
+    if (!temp) {
+        std::cerr << "Failed to load base texture: " << firstPath << std::endl;
+        return textureArrayID;
+    }
+    stbi_image_free(temp);
+
+    // Allocate the storage on GPU (width x height x NumberOfImages)
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, width, height, texturePaths.size(), 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+    // Upload images to layers
+    for (int i = 0; i < texturePaths.size(); i++) {
+        std::string fullPath = "textures/" + texturePaths[i];
+        unsigned char* data = stbi_load(fullPath.c_str(), &width, &height, &nrChannels, 0);
+        if (data) {
+            GLenum format = (nrChannels == 4) ? GL_RGBA : GL_RGB;
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, width, height, 1, format, GL_UNSIGNED_BYTE, data);
+            stbi_image_free(data);
+        }
+        else {
+            std::cerr << "Failed to load texture layer: " << fullPath << std::endl;
+        }
+    }
+
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+    // Texture Parameters
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+    if (glfwExtensionSupported("GL_EXT_texture_filter_anisotropic")) {
+        float aniso = 0.0f;
+        glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &aniso);
+        glTexParameterf(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_ANISOTROPY, aniso);
+    }
+    return textureArrayID;
+}
@@ -2,19 +2,29 @@
 
 #include <vector>
 #include <cmath>
-#include <glad/glad.h>
-#include <glm/glm.hpp>
-#include <glm/gtc/matrix_transform.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+#include <memory>
+#include <map>
+#include <algorithm>
+#include <bit>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CHUNK_MESHER_SSE2
+#include <emmintrin.h>
+#endif
 
 #include "block_manager.hpp"
-#include "shader_s.hpp"
+#include "terrain_noise.hpp"
 
-// Access the global manager defined in main.cpp
-extern BlockManager globalBlockManager;
-
-// Size of one chunk in blocks
+// Size of one chunk section in blocks, along all three axes
 const int CHUNK_SIZE = 16;
 
+// A chunk is a column of sections stacked along Y, bottom first
+const int CHUNK_SECTIONS = 8;
+const int WORLD_HEIGHT = CHUNK_SIZE * CHUNK_SECTIONS;
+
 enum BlockID : uint8_t {
     BLOCK_AIR = 0,
     BLOCK_DIRT = 1,
@@ -22,59 +32,324 @@ enum BlockID : uint8_t {
     BLOCK_GRASS = 3
 };
 
+// Block faces, in the order the mesher walks them
+enum BlockFace : uint8_t {
+    FACE_TOP = 0,    // +Y
+    FACE_BOTTOM = 1, // -Y
+    FACE_FRONT = 2,  // +Z
+    FACE_BACK = 3,   // -Z
+    FACE_LEFT = 4,   // -X
+    FACE_RIGHT = 5   // +X
+};
+
+// Outward normal of each BlockFace
+const int FACE_NORMALS[6][3] = {
+    { 0, 1, 0 }, { 0, -1, 0 },
+    { 0, 0, 1 }, { 0, 0, -1 },
+    { -1, 0, 0 }, { 1, 0, 0 }
+};
+
+// Packed chunk vertex (8 bytes). Position is local to the section (0..CHUNK_SIZE),
+// the section origin comes from a per-draw uniform. Normal and UV are derived in the
+// vertex shader from the face index and the position.
+struct ChunkVertex {
+    uint8_t x, y, z;
+    uint8_t face;    // BlockFace
+    uint16_t layer;  // Texture array layer
+    uint16_t unused = 0;
+};
+static_assert(sizeof(ChunkVertex) == 8, "ChunkVertex must stay 8 bytes");
+
+// Horizontal neighbours of a chunk, as indices into ChunkBorders.
+// Opposite sides differ only in the lowest bit (side ^ 1).
+enum ChunkSide : uint8_t {
+    SIDE_NEG_X = 0,
+    SIDE_POS_X = 1,
+    SIDE_NEG_Z = 2,
+    SIDE_POS_Z = 3
+};
+
+// Chunk offset towards each ChunkSide
+const int SIDE_OFFSETS[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+
+// Read-only copy of the blocks just across each side of a section, taken from the
+// same section of the loaded neighbour chunks by World. The mesher uses it to hide
+// faces against them. A side whose neighbour isn't loaded counts as air.
+struct ChunkBorders {
+    bool loaded[4] = { false, false, false, false };
+    BlockID edge[4][CHUNK_SIZE][CHUNK_SIZE]; // [side][y][x or z along the edge]
+};
+
+// How generateMesh turns blocks into quads.
+// Naive: one quad per exposed face. Greedy: merges same-texture coplanar faces.
+enum class MeshingMode {
+    Naive,
+    Greedy
+};
+
+// Everything the mesher reads for one section, copied out of the world on the main
+// thread so the CPU side of meshing can run on a worker while the chunk keeps changing.
+struct MeshInput {
+    int x = 0, z = 0; // Chunk coordinates
+    int section = 0;  // Which section of the column
+    MeshingMode mode = MeshingMode::Greedy; // Chunk::meshingMode when the input was taken
+    BlockID blocks[CHUNK_SIZE][CHUNK_SIZE][CHUNK_SIZE]; // Y, X, Z
+    BlockID above[CHUNK_SIZE][CHUNK_SIZE]; // X, Z: bottom layer of the section above
+    BlockID below[CHUNK_SIZE][CHUNK_SIZE]; // X, Z: top layer of the section below
+    ChunkBorders borders;
+};
+
+// Worst case a section can produce: a 3D checkerboard exposes 3 faces per block
+const int MAX_CHUNK_QUADS = CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE * 3;
+static_assert(MAX_CHUNK_QUADS * 4 <= 65536, "Quad vertices must be addressable with 16-bit indices");
+
+// Blocks of one 16^3 chunk, stored as a palette of the block types present plus one
+// bit-packed palette index per block. The index width is 0, 1, 2, 4 or 8 bits, the
+// smallest that fits the palette: a chunk of stone, grass and air takes 1 KB instead
+// of 4 KB, a chunk of only air takes no index data at all. set() widens the indices
+// when a new block type comes in. The palette only grows; copyFrom() rebuilds it tight.
+// Block order is Y, X, Z like the old flat array and the save format.
+class BlockStorage {
+public:
+    static const int VOLUME = CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE;
+
+    explicit BlockStorage(BlockID fillBlock = BLOCK_AIR) {
+        fill(fillBlock);
+    }
+
+    BlockID get(int x, int y, int z) const {
+        if (bits == 0) return palette[0];
+        int i = indexOf(x, y, z);
+        int perByte = 8 / bits;
+        int index = (data[i / perByte] >> ((i % perByte) * bits)) & ((1 << bits) - 1);
+        return palette[index];
+    }
+
+    void set(int x, int y, int z, BlockID type) {
+        int index = paletteIndex(type);
+        if (index < 0) {
+            // New block type: widen first if the palette outgrows the index width
+            palette.push_back(type);
+            index = (int)palette.size() - 1;
+            if (palette.size() > ((size_t)1 << bits)) {
+                repack(widthFor(palette.size()));
+            }
+        }
+        if (bits == 0) return; // Still uniform and type is the one block
+
+        int i = indexOf(x, y, z);
+        int perByte = 8 / bits;
+        int shift = (i % perByte) * bits;
+        uint8_t& byte = data[i / perByte];
+        byte = (uint8_t)((byte & ~(((1 << bits) - 1) << shift)) | (index << shift));
+    }
+
+    // Every block set to one type
+    void fill(BlockID type) {
+        palette.assign(1, type);
+        bits = 0;
+        data.clear();
+    }
+
+    // All 4096 blocks as plain bytes, Y-major
+    void copyTo(uint8_t* out) const {
+        if (bits == 0) {
+            memset(out, palette[0], VOLUME);
+            return;
+        }
+        int perByte = 8 / bits;
+        int mask = (1 << bits) - 1;
+        for (int i = 0; i < VOLUME; i += perByte) {
+            uint8_t byte = data[i / perByte];
+            for (int j = 0; j < perByte; j++) {
+                out[i + j] = palette[(byte >> (j * bits)) & mask];
+            }
+        }
+    }
+
+    // Replaces everything with 4096 plain bytes (Y-major), with the tightest palette
+    void copyFrom(const uint8_t* in) {
+        int lookup[256];
+        memset(lookup, -1, sizeof(lookup));
+        palette.clear();
+        for (int i = 0; i < VOLUME; i++) {
+            if (lookup[in[i]] < 0) {
+                lookup[in[i]] = (int)palette.size();
+                palette.push_back((BlockID)in[i]);
+            }
+        }
+
+        bits = widthFor(palette.size());
+        data.assign((size_t)VOLUME * bits / 8, 0);
+        if (bits == 0) return;
+
+        int perByte = 8 / bits;
+        for (int i = 0; i < VOLUME; i++) {
+            data[i / perByte] |= (uint8_t)(lookup[in[i]] << ((i % perByte) * bits));
+        }
+    }
+
+    bool isUniform() const { return bits == 0; }
+    int bitsPerBlock() const { return bits; }
+    size_t paletteSize() const { return palette.size(); }
+
+    // Heap bytes held by this storage
+    size_t memoryUsage() const {
+        return palette.capacity() * sizeof(BlockID) + data.capacity();
+    }
+
+private:
+    std::vector<BlockID> palette; // Never empty
+    std::vector<uint8_t> data;    // VOLUME * bits / 8 bytes, low bits first
+    int bits = 0;
+
+    static int indexOf(int x, int y, int z) {
+        return (y * CHUNK_SIZE + x) * CHUNK_SIZE + z;
+    }
+
+    static int widthFor(size_t paletteSize) {
+        if (paletteSize > 16) return 8;
+        if (paletteSize > 4) return 4;
+        if (paletteSize > 2) return 2;
+        if (paletteSize > 1) return 1;
+        return 0;
+    }
+
+    int paletteIndex(BlockID type) const {
+        for (size_t i = 0; i < palette.size(); i++) {
+            if (palette[i] == type) return (int)i;
+        }
+        return -1;
+    }
+
+    // Re-encodes the current indices at a new width
+    void repack(int newBits) {
+        std::vector<uint8_t> newData((size_t)VOLUME * newBits / 8, 0);
+        int newPerByte = 8 / newBits;
+        for (int i = 0; i < VOLUME; i++) {
+            int index = 0;
+            if (bits > 0) {
+                int perByte = 8 / bits;
+                index = (data[i / perByte] >> ((i % perByte) * bits)) & ((1 << bits) - 1);
+            }
+            newData[i / newPerByte] |= (uint8_t)(index << ((i % newPerByte) * newBits));
+        }
+        data.swap(newData);
+        bits = newBits;
+    }
+};
+
+// A column of CHUNK_SECTIONS sections. Block data and meshes are per section:
+// sections of a single block type (open sky, solid rock) cost almost no memory
+// and World skips them when meshing.
+class MeshUploader;
+
 struct Chunk {
     int x, z; // Chunk coordinates
-    unsigned int VAO, VBO = 0;
-    int vertexCount = 0;
+
+    // Mesh of one section, as handed to the MeshUploader
+    struct SectionMesh {
+        int vertexCount = 0;
+        int indexCount = 0;    // 6 per quad
+
+        // Where ArenaMeshUploader (world_renderer.hpp) put the vertices: a range of
+        // VertexArena, kept across remeshes while they fit
+        uint32_t first = 0;
+        uint32_t capacity = 0; // 0 = no range
+
+        // One hash per uploaded quad (8 bytes for its 32 bytes of vertices), only kept
+        // for sections that were edited, so the next edit can upload just the quads that
+        // changed (see ArenaMeshUploader::patch)
+        std::vector<uint64_t> uploadedQuads;
+    };
+    SectionMesh meshes[CHUNK_SECTIONS];
 
     bool isModified = false;
+    bool drawn = false; // Drawn at least once (for the trace's "first drawn")
+
+    // State shared with this chunk's in-flight mesh jobs, which can outlive the chunk.
+    // Every mesh request bumps its section's meshRevision; only the result of the
+    // latest one is kept.
+    struct JobState {
+        std::atomic<bool> cancelled{ false };
+        std::atomic<uint32_t> meshRevision[CHUNK_SECTIONS] = {};
+    };
+    std::shared_ptr<JobState> jobs = std::make_shared<JobState>();
+
+    // Shared by all chunks, switch it and remesh to compare the two meshers. Main thread
+    // only: mesh jobs read the copy in their MeshInput.
+    static inline MeshingMode meshingMode = MeshingMode::Greedy;
 
-    // Block data: Y, X, Z
-    BlockID blocks[CHUNK_SIZE][CHUNK_SIZE][CHUNK_SIZE];
+    // Block data, bottom section first. Read and written through getBlock/setBlock.
+    BlockStorage sections[CHUNK_SECTIONS];
 
     // Constructor: Just sets coordinates. Does NOT generate yet.
     Chunk(int chunkX, int chunkZ) : x(chunkX), z(chunkZ) {
     }
 
-    void draw(Shader& shader) {
-        shader.setMat4("model", glm::mat4(1.0f));
-        glBindVertexArray(VAO);
-        glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+    void del(MeshUploader& uploader) {
+        for (int section = 0; section < CHUNK_SECTIONS; section++) {
+            clearMesh(section, uploader);
+        }
+    }
+
+    // Frees a section's mesh and drops any mesh job still in flight for it
+    void clearMesh(int section, MeshUploader& uploader);
+
+    int vertexCount() const {
+        int total = 0;
+        for (const SectionMesh& mesh : meshes) total += mesh.vertexCount;
+        return total;
     }
 
-    void del() {
-        glDeleteVertexArrays(1, &VAO);
-        glDeleteBuffers(1, &VBO);
+    // Local x/z, column y (0..WORLD_HEIGHT), must be inside the chunk
+    BlockID getBlock(int x, int y, int z) const {
+        return sections[y / CHUNK_SIZE].get(x, y % CHUNK_SIZE, z);
     }
 
     void setBlock(int x, int y, int z, BlockID type) {
         // Bounds check
-        if (x >= 0 && x < CHUNK_SIZE && y >= 0 && y < CHUNK_SIZE && z >= 0 && z < CHUNK_SIZE) {
-            blocks[y][x][z] = type;
+        if (x >= 0 && x < CHUNK_SIZE && y >= 0 && y < WORLD_HEIGHT && z >= 0 && z < CHUNK_SIZE) {
+            sections[y / CHUNK_SIZE].set(x, y % CHUNK_SIZE, z, type);
             isModified = true;
-            generateMesh(); // Rebuild the visuals
+            // The mesh is rebuilt by World, which also knows about the neighbours
         }
     }
 
-    bool isSolid(int x, int y, int z) {
-        // If outside the chunk bounds, treat it as AIR (so we draw the edge faces)
-        if (x < 0 || x >= CHUNK_SIZE ||
-            y < 0 || y >= CHUNK_SIZE ||
-            z < 0 || z >= CHUNK_SIZE)
-        {
-            return false;
+    // True if the section is one block type and that type is opaque (or has nothing to draw)
+    bool isSolidSection(int section) const {
+        return sections[section].isUniform() && globalBlockManager.get(sections[section].get(0, 0, 0)).isOpaque();
+    }
+    bool isEmptySection(int section) const {
+        return sections[section].isUniform() && !globalBlockManager.get(sections[section].get(0, 0, 0)).isSolid();
+    }
+
+    // Copies the outermost layer of blocks of one section on the given side
+    void copyEdge(int side, int section, BlockID out[CHUNK_SIZE][CHUNK_SIZE]) const {
+        const BlockStorage& blocks = sections[section];
+        for (int y = 0; y < CHUNK_SIZE; y++) {
+            for (int i = 0; i < CHUNK_SIZE; i++) {
+                switch (side) {
+                case SIDE_NEG_X: out[y][i] = blocks.get(0, y, i); break;
+                case SIDE_POS_X: out[y][i] = blocks.get(CHUNK_SIZE - 1, y, i); break;
+                case SIDE_NEG_Z: out[y][i] = blocks.get(i, y, 0); break;
+                default:         out[y][i] = blocks.get(i, y, CHUNK_SIZE - 1); break;
+                }
+            }
         }
-        return blocks[y][x][z] != BLOCK_AIR;
     }
 
-    void addVertex(std::vector<float>& v,
-        float x, float y, float z,
-        float nx, float ny, float nz,
-        float r, float g, float b,
-        float u, float v_tex, float layer) {
+    // All sections as plain bytes (WORLD_HEIGHT layers, Y-major), for saving
+    void copyBlocks(uint8_t* out) const {
+        for (int section = 0; section < CHUNK_SECTIONS; section++) {
+            sections[section].copyTo(out + section * BlockStorage::VOLUME);
+        }
+    }
 
-        // We now push 12 floats per vertex
-        v.insert(v.end(), { x,y,z, nx,ny,nz, r,g,b, u,v_tex, layer });
+    void loadBlocks(const uint8_t* in) {
+        for (int section = 0; section < CHUNK_SECTIONS; section++) {
+            sections[section].copyFrom(in + section * BlockStorage::VOLUME);
+        }
     }
 
     void generateBlocks() {
@@ -94,148 +369,417 @@ struct Chunk {
         float scale3 = 0.1f;
         float amp3 = 1.0f;
 
-        for (int x_local = 0; x_local < CHUNK_SIZE; x_local++) {
-            for (int z_local = 0; z_local < CHUNK_SIZE; z_local++) {
-
+        // --- Ranges: tall mountains. Only where this wide noise rises above
+        // rangeThreshold; everywhere else (most of the world) the octave adds nothing and
+        // the terrain is the one from the three octaves above. Chunks saved before the
+        // ranges existed keep their old terrain, so a range can end in a cliff there. ---
+        float scale4 = 0.008f;
+        float rangeThreshold = 0.3f;
+        float amp4 = 150.0f; // Noise rarely gets past ~0.7, so peaks of ~60 blocks
+
+        // Noise for all columns at once, one batch per octave (the same values
+        // stb_perlin_noise3 gives, see TerrainNoise)
+        const int COLUMNS = CHUNK_SIZE * CHUNK_SIZE;
+        const float scales[4] = { scale1, scale2, scale3, scale4 };
+        float noise[4][COLUMNS]; // [octave][x_local * CHUNK_SIZE + z_local]
+        float noiseX[COLUMNS], noiseZ[COLUMNS];
+        for (int octave = 0; octave < 4; octave++) {
+            for (int i = 0; i < COLUMNS; i++) {
                 // Global Coordinates
-                float worldX = (float)(x * CHUNK_SIZE + x_local);
-                float worldZ = (float)(z * CHUNK_SIZE + z_local);
+                float worldX = (float)(x * CHUNK_SIZE + i / CHUNK_SIZE);
+                float worldZ = (float)(z * CHUNK_SIZE + i % CHUNK_SIZE);
+                noiseX[i] = (worldX + seed) * scales[octave];
+                noiseZ[i] = (worldZ + seed) * scales[octave];
+            }
+            TerrainNoise::noise2(noiseX, noiseZ, noise[octave], COLUMNS);
+        }
 
-                // Calculate Octaves
-                float noise1 = stb_perlin_noise3((worldX + seed) * scale1, (worldZ + seed) * scale1, 0, 0, 0, 0);
-                float noise2 = stb_perlin_noise3((worldX + seed) * scale2, (worldZ + seed) * scale2, 0, 0, 0, 0);
-                float noise3 = stb_perlin_noise3((worldX + seed) * scale3, (worldZ + seed) * scale3, 0, 0, 0, 0);
+        int heights[CHUNK_SIZE][CHUNK_SIZE]; // X, Z
+        int minHeight = WORLD_HEIGHT, maxHeight = 0;
 
-                // Combine them (Fractal Noise)
-                float combinedHeight = (noise1 * amp1) + (noise2 * amp2) + (noise3 * amp3);
+        for (int x_local = 0; x_local < CHUNK_SIZE; x_local++) {
+            for (int z_local = 0; z_local < CHUNK_SIZE; z_local++) {
+                int column = x_local * CHUNK_SIZE + z_local;
+
+                // Combine the octaves (Fractal Noise)
+                float combinedHeight = (noise[0][column] * amp1) + (noise[1][column] * amp2) + (noise[2][column] * amp3);
+                combinedHeight += std::max(0.0f, noise[3][column] - rangeThreshold) * amp4;
 
                 // Convert to Integer Height
                 int height = baseHeight + (int)combinedHeight;
 
                 // Safety Clamp (Don't go outside chunk memory!)
                 if (height < 1) height = 1;
-                if (height >= CHUNK_SIZE) height = CHUNK_SIZE - 1;
+                if (height >= WORLD_HEIGHT) height = WORLD_HEIGHT - 1;
 
-                // Fill Blocks
-                for (int y = 0; y < CHUNK_SIZE; y++) {
-                    if (y < height) {
-                        blocks[y][x_local][z_local] = BLOCK_STONE;
-                    }
-                    else if (y == height) {
-                        blocks[y][x_local][z_local] = BLOCK_GRASS;
-                    }
-                    else {
-                        blocks[y][x_local][z_local] = BLOCK_AIR;
+                heights[x_local][z_local] = height;
+                minHeight = std::min(minHeight, height);
+                maxHeight = std::max(maxHeight, height);
+            }
+        }
+
+        // Fill Blocks, section by section. Sections fully below or above the terrain
+        // become a single value; the rest is filled flat and packed in one go.
+        BlockID generated[CHUNK_SIZE][CHUNK_SIZE][CHUNK_SIZE]; // Y, X, Z
+        for (int section = 0; section < CHUNK_SECTIONS; section++) {
+            int bottom = section * CHUNK_SIZE;
+            if (bottom + CHUNK_SIZE <= minHeight) {
+                sections[section].fill(BLOCK_STONE);
+                continue;
+            }
+            if (bottom > maxHeight) {
+                sections[section].fill(BLOCK_AIR);
+                continue;
+            }
+
+            for (int x_local = 0; x_local < CHUNK_SIZE; x_local++) {
+                for (int z_local = 0; z_local < CHUNK_SIZE; z_local++) {
+                    int height = heights[x_local][z_local];
+                    for (int y = 0; y < CHUNK_SIZE; y++) {
+                        if (bottom + y < height) {
+                            generated[y][x_local][z_local] = BLOCK_STONE;
+                        }
+                        else if (bottom + y == height) {
+                            generated[y][x_local][z_local] = BLOCK_GRASS;
+                        }
+                        else {
+                            generated[y][x_local][z_local] = BLOCK_AIR;
+                        }
                     }
                 }
             }
+            sections[section].copyFrom((const uint8_t*)generated);
         }
     }
 
-    void generateMesh() {
-        if (VAO != 0) {
-            glDeleteVertexArrays(1, &VAO);
-            glDeleteBuffers(1, &VBO);
+    // Emits one quad covering w x h blocks of the given face.
+    // (bx, by, bz) is the local block the quad starts at, w runs along the face's
+    // first axis and h along its second (X/Z for top/bottom, X/Y for front/back,
+    // Z/Y for left/right). The shader tiles UVs from the position, so the texture
+    // still repeats once per block on merged quads.
+    static void addFace(std::vector<ChunkVertex>& v, int face, int bx, int by, int bz, int w, int h, int layer) {
+        // Corner order (along the A/B axes) so each quad winds counter-clockwise seen from outside
+        static const int ccw[4][2] = { {0, 0}, {1, 0}, {1, 1}, {0, 1} };
+        static const int cw[4][2] = { {0, 0}, {0, 1}, {1, 1}, {1, 0} };
+        bool flip = (face == FACE_TOP || face == FACE_BACK || face == FACE_RIGHT);
+        const int (*corners)[2] = flip ? cw : ccw;
+
+        ChunkVertex quad[4];
+        for (int c = 0; c < 4; c++) {
+            int a = corners[c][0] * w;
+            int b = corners[c][1] * h;
+            int px, py, pz;
+
+            switch (face) {
+            case FACE_TOP:    px = bx + a; py = by + 1; pz = bz + b; break;
+            case FACE_BOTTOM: px = bx + a; py = by;     pz = bz + b; break;
+            case FACE_FRONT:  px = bx + a; py = by + b; pz = bz + 1; break;
+            case FACE_BACK:   px = bx + a; py = by + b; pz = bz;     break;
+            case FACE_LEFT:   px = bx;     py = by + b; pz = bz + a; break;
+            default:          px = bx + 1; py = by + b; pz = bz + a; break;
+            }
+
+            quad[c] = { (uint8_t)px, (uint8_t)py, (uint8_t)pz, (uint8_t)face, (uint16_t)layer };
         }
 
-        std::vector<float> vertices;
+        // 4 corners, the shared index buffer turns them into two triangles
+        v.insert(v.end(), quad, quad + 4);
+    }
 
-        for (int y = 0; y < CHUNK_SIZE; y++) {
-            for (int i = 0; i < CHUNK_SIZE; i++) {
-                for (int j = 0; j < CHUNK_SIZE; j++) {
+    // Occupancy of a section as bit rows along Z: bit (z + 1) of solid[y][x] is set if
+    // block (x, y, z) has faces to draw, and of opaque[y + 1][x + 1] if it hides its
+    // neighbours' faces. `opaque` has a one block border around the section, for x, y, z
+    // in -1..CHUNK_SIZE (the border corners are never needed). Below the world counts
+    // as opaque (nothing is ever seen from there), above the world and unloaded
+    // neighbours count as air (so we draw the edge faces).
+    struct Occupancy {
+        uint32_t solid[CHUNK_SIZE][CHUNK_SIZE];
+        uint32_t opaque[CHUNK_SIZE + 2][CHUNK_SIZE + 2];
+    };
+
+    // Bit (z + 1) set for every opaque block of row[z]
+    static uint32_t opaqueBits(const BlockProperties* props, const BlockID row[CHUNK_SIZE]) {
+        uint32_t bits = 0;
+        for (int z = 0; z < CHUNK_SIZE; z++) {
+            bits |= (uint32_t)((props[row[z]].flags >> 1) & 1) << (z + 1);
+        }
+        return bits;
+    }
 
-                    BlockID block = blocks[y][i][j];
-                    if (block == BLOCK_AIR) continue;
+    // Solid and opaque bits of a row of blocks, at bit (z + 1)
+    static void rowFlags(const BlockProperties* props, const BlockID row[CHUNK_SIZE], uint32_t& solid, uint32_t& opaque) {
+        static_assert(BLOCK_FLAG_SOLID == 1 && BLOCK_FLAG_OPAQUE == 2, "flag bits are shifted into place below");
+#if defined(CHUNK_MESHER_SSE2)
+        static_assert(CHUNK_SIZE == 16 && sizeof(BlockID) == 1, "one row must be one SSE register");
+        // Rows of one block type (all air, all stone) are most of a terrain section
+        __m128i blocks = _mm_loadu_si128((const __m128i*)row);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(blocks, _mm_set1_epi8((char)row[0]))) == 0xFFFF) {
+            const uint32_t fullRow = ((1u << CHUNK_SIZE) - 1) << 1;
+            uint32_t flags = props[row[0]].flags;
+            solid = (flags & BLOCK_FLAG_SOLID) ? fullRow : 0;
+            opaque = (flags & BLOCK_FLAG_OPAQUE) ? fullRow : 0;
+            return;
+        }
 
-                    float wx = x * CHUNK_SIZE + i;
-                    float wy = (float)y;
-                    float wz = z * CHUNK_SIZE + j;
+        // Look the flags up into one register, then move each flag bit to the top
+        // of its byte and collect all 16 with movemask
+        uint64_t low = 0, high = 0;
+        for (int z = 0; z < 8; z++) {
+            low |= (uint64_t)props[row[z]].flags << (z * 8);
+            high |= (uint64_t)props[row[z + 8]].flags << (z * 8);
+        }
+        __m128i f = _mm_set_epi64x((long long)high, (long long)low);
+        solid = (uint32_t)_mm_movemask_epi8(_mm_slli_epi16(f, 7)) << 1;
+        opaque = (uint32_t)_mm_movemask_epi8(_mm_slli_epi16(f, 6)) << 1;
+#else
+        solid = opaque = 0;
+        for (int z = 0; z < CHUNK_SIZE; z++) {
+            uint32_t flags = props[row[z]].flags;
+            solid |= (flags & 1) << (z + 1);
+            opaque |= ((flags >> 1) & 1) << (z + 1);
+        }
+#endif
+    }
 
-                    BlockFaceTextures tex = globalBlockManager.blockData[block];
+    static void buildOccupancy(const MeshInput& in, Occupancy& occ) {
+        memset(&occ, 0, sizeof(occ));
+        const BlockProperties* props = globalBlockManager.properties;
+        const ChunkBorders& borders = in.borders;
 
-                    // === TOP FACE (+Y) ===
-                    if (!isSolid(i, y + 1, j)) {
-                        addVertex(vertices, wx, wy + 1, wz, 0, 1, 0, 1, 1, 1, 0.0f, 0.0f, (float)tex.topLayer);
-                        addVertex(vertices, wx + 1, wy + 1, wz, 0, 1, 0, 1, 1, 1, 1.0f, 0.0f, (float)tex.topLayer);
-                        addVertex(vertices, wx + 1, wy + 1, wz + 1, 0, 1, 0, 1, 1, 1, 1.0f, 1.0f, (float)tex.topLayer);
-                        addVertex(vertices, wx + 1, wy + 1, wz + 1, 0, 1, 0, 1, 1, 1, 1.0f, 1.0f, (float)tex.topLayer);
-                        addVertex(vertices, wx, wy + 1, wz + 1, 0, 1, 0, 1, 1, 1, 0.0f, 1.0f, (float)tex.topLayer);
-                        addVertex(vertices, wx, wy + 1, wz, 0, 1, 0, 1, 1, 1, 0.0f, 0.0f, (float)tex.topLayer);
-                    }
+        for (int y = 0; y < CHUNK_SIZE; y++) {
+            for (int x = 0; x < CHUNK_SIZE; x++) {
+                uint32_t solid, opaque;
+                rowFlags(props, in.blocks[y][x], solid, opaque);
+                // The blocks just across -Z and +Z
+                if (borders.loaded[SIDE_NEG_Z]) opaque |= (uint32_t)props[borders.edge[SIDE_NEG_Z][y][x]].isOpaque();
+                if (borders.loaded[SIDE_POS_Z]) opaque |= (uint32_t)props[borders.edge[SIDE_POS_Z][y][x]].isOpaque() << (CHUNK_SIZE + 1);
+                occ.solid[y][x] = solid;
+                occ.opaque[y + 1][x + 1] = opaque;
+            }
 
-                    // === BOTTOM FACE (-Y) ===
-                    if (!isSolid(i, y - 1, j)) {
-                        addVertex(vertices, wx, wy, wz, 0, -1, 0, 1, 1, 1, 0.0f, 0.0f, (float)tex.bottomLayer);
-                        addVertex(vertices, wx + 1, wy, wz + 1, 0, -1, 0, 1, 1, 1, 1.0f, 1.0f, (float)tex.bottomLayer);
-                        addVertex(vertices, wx + 1, wy, wz, 0, -1, 0, 1, 1, 1, 1.0f, 0.0f, (float)tex.bottomLayer);
-                        addVertex(vertices, wx + 1, wy, wz + 1, 0, -1, 0, 1, 1, 1, 1.0f, 1.0f, (float)tex.bottomLayer);
-                        addVertex(vertices, wx, wy, wz, 0, -1, 0, 1, 1, 1, 0.0f, 0.0f, (float)tex.bottomLayer);
-                        addVertex(vertices, wx, wy, wz + 1, 0, -1, 0, 1, 1, 1, 0.0f, 1.0f, (float)tex.bottomLayer);
-                    }
+            // Rows just across -X and +X
+            if (borders.loaded[SIDE_NEG_X]) occ.opaque[y + 1][0] = opaqueBits(props, borders.edge[SIDE_NEG_X][y]);
+            if (borders.loaded[SIDE_POS_X]) occ.opaque[y + 1][CHUNK_SIZE + 1] = opaqueBits(props, borders.edge[SIDE_POS_X][y]);
+        }
 
-                    // === FRONT FACE (+Z) ===
-                    if (!isSolid(i, y, j + 1)) {
-                        addVertex(vertices, wx, wy, wz + 1, 0, 0, 1, 1, 1, 1, 0.0f, 1.0f, (float)tex.sideLayer);
-                        addVertex(vertices, wx + 1, wy, wz + 1, 0, 0, 1, 1, 1, 1, 1.0f, 1.0f, (float)tex.sideLayer);
-                        addVertex(vertices, wx + 1, wy + 1, wz + 1, 0, 0, 1, 1, 1, 1, 1.0f, 0.0f, (float)tex.sideLayer);
-                        addVertex(vertices, wx + 1, wy + 1, wz + 1, 0, 0, 1, 1, 1, 1, 1.0f, 0.0f, (float)tex.sideLayer);
-                        addVertex(vertices, wx, wy + 1, wz + 1, 0, 0, 1, 1, 1, 1, 0.0f, 0.0f, (float)tex.sideLayer);
-                        addVertex(vertices, wx, wy, wz + 1, 0, 0, 1, 1, 1, 1, 0.0f, 1.0f, (float)tex.sideLayer);
-                    }
+        // Layers below and above
+        const uint32_t fullRow = ((1u << CHUNK_SIZE) - 1) << 1;
+        for (int x = 0; x < CHUNK_SIZE; x++) {
+            occ.opaque[0][x + 1] = in.section == 0 ? fullRow : opaqueBits(props, in.below[x]);
+            occ.opaque[CHUNK_SIZE + 1][x + 1] = in.section == CHUNK_SECTIONS - 1 ? 0 : opaqueBits(props, in.above[x]);
+        }
+    }
 
-                    // === BACK FACE (-Z) ===
-                    if (!isSolid(i, y, j - 1)) {
-                        addVertex(vertices, wx, wy, wz, 0, 0, -1, 1, 1, 1, 0.0f, 1.0f, (float)tex.sideLayer);
-                        addVertex(vertices, wx, wy + 1, wz, 0, 0, -1, 1, 1, 1, 0.0f, 0.0f, (float)tex.sideLayer);
-                        addVertex(vertices, wx + 1, wy + 1, wz, 0, 0, -1, 1, 1, 1, 1.0f, 0.0f, (float)tex.sideLayer);
-                        addVertex(vertices, wx + 1, wy + 1, wz, 0, 0, -1, 1, 1, 1, 1.0f, 0.0f, (float)tex.sideLayer);
-                        addVertex(vertices, wx + 1, wy, wz, 0, 0, -1, 1, 1, 1, 1.0f, 1.0f, (float)tex.sideLayer);
-                        addVertex(vertices, wx, wy, wz, 0, 0, -1, 1, 1, 1, 0.0f, 1.0f, (float)tex.sideLayer);
+    // Exposed faces, 16 blocks at a time: bit z of visible[face][y][x] is set if block
+    // (x, y, z) is solid and its neighbour across that face isn't opaque. Faces along Z
+    // compare a row with the opaque row shifted by one, the other four with the
+    // neighbouring opaque row.
+    static void findVisibleFaces(const Occupancy& occ, uint16_t visible[6][CHUNK_SIZE][CHUNK_SIZE]) {
+        for (int y = 0; y < CHUNK_SIZE; y++) {
+            for (int x = 0; x < CHUNK_SIZE; x++) {
+                uint32_t row = occ.solid[y][x];
+                uint32_t opaque = occ.opaque[y + 1][x + 1];
+                // >> 1 drops the -Z border bit, the uint16 cast the +Z one
+                visible[FACE_TOP][y][x] = (uint16_t)((row & ~occ.opaque[y + 2][x + 1]) >> 1);
+                visible[FACE_BOTTOM][y][x] = (uint16_t)((row & ~occ.opaque[y][x + 1]) >> 1);
+                visible[FACE_FRONT][y][x] = (uint16_t)((row & ~(opaque >> 1)) >> 1);
+                visible[FACE_BACK][y][x] = (uint16_t)((row & ~(opaque << 1)) >> 1);
+                visible[FACE_LEFT][y][x] = (uint16_t)((row & ~occ.opaque[y + 1][x]) >> 1);
+                visible[FACE_RIGHT][y][x] = (uint16_t)((row & ~occ.opaque[y + 1][x + 2]) >> 1);
+            }
+        }
+    }
+
+    // One quad per exposed block face
+    static void buildNaiveMesh(const MeshInput& in, std::vector<ChunkVertex>& vertices) {
+        Occupancy occ;
+        buildOccupancy(in, occ);
+        uint16_t visible[6][CHUNK_SIZE][CHUNK_SIZE];
+        findVisibleFaces(occ, visible);
+
+        const BlockProperties* props = globalBlockManager.properties;
+        for (int y = 0; y < CHUNK_SIZE; y++) {
+            for (int x = 0; x < CHUNK_SIZE; x++) {
+                for (int face = 0; face < 6; face++) {
+                    // Walk the set bits, lowest first
+                    for (unsigned int bits = visible[face][y][x]; bits != 0; bits &= bits - 1) {
+                        int z = std::countr_zero(bits);
+                        addFace(vertices, face, x, y, z, 1, 1, props[in.blocks[y][x][z]].faceLayers[face]);
                     }
+                }
+            }
+        }
+    }
 
-                    // === LEFT FACE (-X) ===
-                    if (!isSolid(i - 1, y, j)) {
-                        addVertex(vertices, wx, wy + 1, wz, -1, 0, 0, 1, 1, 1, 1.0f, 0.0f, (float)tex.sideLayer);
-                        addVertex(vertices, wx, wy, wz, -1, 0, 0, 1, 1, 1, 1.0f, 1.0f, (float)tex.sideLayer);
-                        addVertex(vertices, wx, wy, wz + 1, -1, 0, 0, 1, 1, 1, 0.0f, 1.0f, (float)tex.sideLayer);
-                        addVertex(vertices, wx, wy, wz + 1, -1, 0, 0, 1, 1, 1, 0.0f, 1.0f, (float)tex.sideLayer);
-                        addVertex(vertices, wx, wy + 1, wz + 1, -1, 0, 0, 1, 1, 1, 0.0f, 0.0f, (float)tex.sideLayer);
-                        addVertex(vertices, wx, wy + 1, wz, -1, 0, 0, 1, 1, 1, 1.0f, 0.0f, (float)tex.sideLayer);
+    // Merges coplanar exposed faces with the same texture layer into maximal rectangles.
+    // Each face direction is swept slice by slice along its normal; every slice has a
+    // 2D mask of visible faces (layer + 1, 0 = nothing) that quads are greedily grown from.
+    static void buildGreedyMesh(const MeshInput& in, std::vector<ChunkVertex>& vertices) {
+        Occupancy occ;
+        buildOccupancy(in, occ);
+        uint16_t visible[6][CHUNK_SIZE][CHUNK_SIZE];
+        findVisibleFaces(occ, visible);
+
+        const BlockProperties* props = globalBlockManager.properties;
+        // [slice][b][a]. Starts zeroed and stays that way between faces: growing the
+        // rectangles consumes every cell that was set.
+        uint16_t masks[CHUNK_SIZE][CHUNK_SIZE][CHUNK_SIZE] = {};
+
+        for (int face = 0; face < 6; face++) {
+            // 1. Scatter the visible faces into the slice masks
+            bool sliceUsed[CHUNK_SIZE] = {};
+            for (int y = 0; y < CHUNK_SIZE; y++) {
+                for (int x = 0; x < CHUNK_SIZE; x++) {
+                    for (unsigned int bits = visible[face][y][x]; bits != 0; bits &= bits - 1) {
+                        int z = std::countr_zero(bits);
+                        int d, a, b;
+                        blockToSlice(face, x, y, z, d, a, b);
+                        masks[d][b][a] = (uint16_t)(props[in.blocks[y][x][z]].faceLayers[face] + 1);
+                        sliceUsed[d] = true;
                     }
+                }
+            }
 
-                    // === RIGHT FACE (+X) ===
-                    if (!isSolid(i + 1, y, j)) {
-                        addVertex(vertices, wx + 1, wy + 1, wz, 1, 0, 0, 1, 1, 1, 0.0f, 0.0f, (float)tex.sideLayer);
-                        addVertex(vertices, wx + 1, wy + 1, wz + 1, 1, 0, 0, 1, 1, 1, 1.0f, 0.0f, (float)tex.sideLayer);
-                        addVertex(vertices, wx + 1, wy, wz + 1, 1, 0, 0, 1, 1, 1, 1.0f, 1.0f, (float)tex.sideLayer);
-                        addVertex(vertices, wx + 1, wy, wz + 1, 1, 0, 0, 1, 1, 1, 1.0f, 1.0f, (float)tex.sideLayer);
-                        addVertex(vertices, wx + 1, wy, wz, 1, 0, 0, 1, 1, 1, 0.0f, 1.0f, (float)tex.sideLayer);
-                        addVertex(vertices, wx + 1, wy + 1, wz, 1, 0, 0, 1, 1, 1, 0.0f, 0.0f, (float)tex.sideLayer);
+            for (int d = 0; d < CHUNK_SIZE; d++) {
+                if (!sliceUsed[d]) continue;
+                uint16_t (&mask)[CHUNK_SIZE][CHUNK_SIZE] = masks[d];
+
+                // 2. Grow rectangles out of the mask
+                for (int b = 0; b < CHUNK_SIZE; b++) {
+                    for (int a = 0; a < CHUNK_SIZE; ) {
+                        int id = mask[b][a];
+                        if (id == 0) { a++; continue; }
+
+                        // Width along A
+                        int w = 1;
+                        while (a + w < CHUNK_SIZE && mask[b][a + w] == id) w++;
+
+                        // Height along B, as long as the whole row matches
+                        int h = 1;
+                        for (; b + h < CHUNK_SIZE; h++) {
+                            bool rowMatches = true;
+                            for (int k = 0; k < w; k++) {
+                                if (mask[b + h][a + k] != id) { rowMatches = false; break; }
+                            }
+                            if (!rowMatches) break;
+                        }
+
+                        int bx, by, bz;
+                        sliceToBlock(face, d, a, b, bx, by, bz);
+                        addFace(vertices, face, bx, by, bz, w, h, id - 1);
+
+                        // Clear the area we just consumed
+                        for (int r = 0; r < h; r++) {
+                            for (int k = 0; k < w; k++) mask[b + r][a + k] = 0;
+                        }
+                        a += w;
                     }
                 }
             }
         }
+    }
+
+    // Local block position to (slice, A, B) coordinates of a face direction
+    static void blockToSlice(int face, int bx, int by, int bz, int& d, int& a, int& b) {
+        if (face == FACE_TOP || face == FACE_BOTTOM) { d = by; a = bx; b = bz; }
+        else if (face == FACE_FRONT || face == FACE_BACK) { d = bz; a = bx; b = by; }
+        else { d = bx; a = bz; b = by; }
+    }
+
+    // Maps (slice, A, B) coordinates of a face direction back to a local block position
+    static void sliceToBlock(int face, int d, int a, int b, int& bx, int& by, int& bz) {
+        if (face == FACE_TOP || face == FACE_BOTTOM) { bx = a; by = d; bz = b; }
+        else if (face == FACE_FRONT || face == FACE_BACK) { bx = a; by = b; bz = d; }
+        else { bx = d; by = b; bz = a; }
+    }
+
+    // Snapshot of one section's blocks and the layers above/below it for the mesher
+    // (borders are filled in by World)
+    void fillMeshInput(int section, MeshInput& in) const {
+        in.x = x;
+        in.z = z;
+        in.section = section;
+        in.mode = meshingMode;
+        sections[section].copyTo((uint8_t*)in.blocks);
+
+        for (int bx = 0; bx < CHUNK_SIZE; bx++) {
+            for (int bz = 0; bz < CHUNK_SIZE; bz++) {
+                in.above[bx][bz] = section + 1 < CHUNK_SECTIONS ? sections[section + 1].get(bx, 0, bz) : BLOCK_AIR;
+                in.below[bx][bz] = section > 0 ? sections[section - 1].get(bx, CHUNK_SIZE - 1, bz) : BLOCK_AIR;
+            }
+        }
+    }
+
+    // CPU stage: safe to run on any thread, touches nothing but its input
+    static void buildMesh(const MeshInput& in, std::vector<ChunkVertex>& vertices) {
+        if (in.mode == MeshingMode::Greedy) {
+            buildGreedyMesh(in, vertices);
+        }
+        else {
+            buildNaiveMesh(in, vertices);
+        }
+    }
+
+    // Synchronous mesh + upload of one section. Faces against loaded neighbours are
+    // culled using their border copies. Supersedes any mesh job still in flight for it.
+    void generateMesh(int section, const ChunkBorders& borders, MeshUploader& uploader);
+
+    // Same as generateMesh, for sections that were edited: the upload goes through
+    // MeshUploader::patch
+    void regenerateMesh(int section, const ChunkBorders& borders, MeshUploader& uploader);
 
-        vertexCount = vertices.size() / 12;
+    // Meshes a section on the calling thread
+    void buildSectionNow(int section, const ChunkBorders& borders, std::vector<ChunkVertex>& vertices) {
+        jobs->meshRevision[section]++;
 
-        glGenVertexArrays(1, &VAO);
-        glGenBuffers(1, &VBO);
+        // Heap allocated, MeshInput is a few KB
+        std::unique_ptr<MeshInput> in = std::make_unique<MeshInput>();
+        fillMeshInput(section, *in);
+        in->borders = borders;
+        buildMesh(*in, vertices);
+    }
+};
 
-        glBindVertexArray(VAO);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+// Where World puts the section meshes it builds. This base class only keeps the counts
+// in SectionMesh, which is all a world without a GPU needs (servers, tools, benchmarks).
+// The game draws through ArenaMeshUploader (world_renderer.hpp), which also sends the
+// vertices to the GPU. Main thread only.
+class MeshUploader {
+public:
+    virtual ~MeshUploader() = default;
+
+    // A new mesh for the section, replacing the old one
+    virtual void upload(Chunk::SectionMesh& mesh, const std::vector<ChunkVertex>& vertices) {
+        mesh.vertexCount = (int)vertices.size();
+        mesh.indexCount = mesh.vertexCount / 4 * 6;
+    }
+
+    // Same, for a section that was just edited, where only a few quads changed
+    virtual void patch(Chunk::SectionMesh& mesh, std::vector<ChunkVertex>&& vertices) {
+        upload(mesh, vertices);
+    }
 
-        // Pos (3)
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 12 * sizeof(float), (void*)0);
-        glEnableVertexAttribArray(0);
-        // Normal (3)
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 12 * sizeof(float), (void*)(3 * sizeof(float)));
-        glEnableVertexAttribArray(1);
-        // Color (3)
-        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 12 * sizeof(float), (void*)(6 * sizeof(float)));
-        glEnableVertexAttribArray(2);
-        // TexCoords + Layer (3)
-        glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, 12 * sizeof(float), (void*)(9 * sizeof(float)));
-        glEnableVertexAttribArray(3);
+    // The section's mesh is gone (cleared, or the chunk unloaded)
+    virtual void release(Chunk::SectionMesh& mesh) {
+        mesh = Chunk::SectionMesh();
     }
 };
+
+inline void Chunk::clearMesh(int section, MeshUploader& uploader) {
+    jobs->meshRevision[section]++;
+
+    uploader.release(meshes[section]);
+    meshes[section] = SectionMesh();
+}
+
+inline void Chunk::generateMesh(int section, const ChunkBorders& borders, MeshUploader& uploader) {
+    std::vector<ChunkVertex> vertices;
+    buildSectionNow(section, borders, vertices);
+    uploader.upload(meshes[section], vertices);
+}
+
+inline void Chunk::regenerateMesh(int section, const ChunkBorders& borders, MeshUploader& uploader) {
+    std::vector<ChunkVertex> vertices;
+    buildSectionNow(section, borders, vertices);
+    uploader.patch(meshes[section], std::move(vertices));
+}
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+// On-disk encoding of a chunk's 16x16x16 block bytes (Y-major, the layout of Chunk::blocks).
+//
+//   [version][encoding][payload]
+//
+// CODEC_RAW      payload is the 4096 block bytes
+// CODEC_RLE      (block, run length as varint) pairs in Y-major order. Stone layers
+//                and the air above the surface become a handful of runs.
+// CODEC_PALETTE  palette size, palette, then one 1/2/4/8-bit index per block
+//                (0 bits when the chunk is a single block type)
+//
+// encodeChunk() tries RLE and palette and keeps the smaller one. Anything encoded is
+// never exactly 4096 bytes, so headerless 4096-byte data from older saves can still be
+// told apart and is read as raw.
+// decodeChunk() does one bounded pass over the input and rejects anything malformed.
+const int CHUNK_CODEC_VERSION = 1;
+const int CHUNK_CODEC_VOLUME = 16 * 16 * 16;
+
+enum ChunkEncoding : uint8_t {
+    CODEC_RAW = 0,
+    CODEC_RLE = 1,
+    CODEC_PALETTE = 2
+};
+
+// === Encoding ===
+
+inline void encodeRLE(const uint8_t* blocks, std::vector<uint8_t>& out) {
+    int i = 0;
+    while (i < CHUNK_CODEC_VOLUME) {
+        uint8_t block = blocks[i];
+        int run = 1;
+        while (i + run < CHUNK_CODEC_VOLUME && blocks[i + run] == block) run++;
+
+        out.push_back(block);
+        // Run length as a little-endian base-128 varint (at most 2 bytes for 4096)
+        unsigned int n = run;
+        while (n >= 0x80) {
+            out.push_back((uint8_t)(n | 0x80));
+            n >>= 7;
+        }
+        out.push_back((uint8_t)n);
+        i += run;
+    }
+}
+
+inline void encodePalette(const uint8_t* blocks, std::vector<uint8_t>& out) {
+    int indexOf[256];
+    memset(indexOf, -1, sizeof(indexOf));
+    std::vector<uint8_t> palette;
+    for (int i = 0; i < CHUNK_CODEC_VOLUME; i++) {
+        if (indexOf[blocks[i]] < 0) {
+            indexOf[blocks[i]] = (int)palette.size();
+            palette.push_back(blocks[i]);
+        }
+    }
+
+    int bits = 0;
+    if (palette.size() > 16) bits = 8;
+    else if (palette.size() > 4) bits = 4;
+    else if (palette.size() > 2) bits = 2;
+    else if (palette.size() > 1) bits = 1;
+
+    out.push_back((uint8_t)(palette.size() - 1)); // 1..256 stored as 0..255
+    out.insert(out.end(), palette.begin(), palette.end());
+    if (bits == 0) return;
+
+    // Indices packed low bits first; 1/2/4/8 divide 8, so nothing straddles a byte
+    size_t start = out.size();
+    out.resize(start + CHUNK_CODEC_VOLUME * bits / 8, 0);
+    int perByte = 8 / bits;
+    for (int i = 0; i < CHUNK_CODEC_VOLUME; i++) {
+        out[start + i / perByte] |= (uint8_t)(indexOf[blocks[i]] << ((i % perByte) * bits));
+    }
+}
+
+inline void encodeChunk(const uint8_t* blocks, std::vector<uint8_t>& out) {
+    std::vector<uint8_t> rle, palette;
+    encodeRLE(blocks, rle);
+    encodePalette(blocks, palette);
+
+    const std::vector<uint8_t>& best = rle.size() <= palette.size() ? rle : palette;
+    uint8_t encoding = rle.size() <= palette.size() ? CODEC_RLE : CODEC_PALETTE;
+
+    out.clear();
+    out.push_back((uint8_t)CHUNK_CODEC_VERSION);
+    if (best.size() + 2 >= (size_t)CHUNK_CODEC_VOLUME) {
+        // Noise doesn't compress; fall back to raw (4098 bytes, never 4096)
+        out.push_back(CODEC_RAW);
+        out.insert(out.end(), blocks, blocks + CHUNK_CODEC_VOLUME);
+        return;
+    }
+    out.push_back(encoding);
+    out.insert(out.end(), best.begin(), best.end());
+}
+
+// === Decoding ===
+
+inline bool decodeRLE(const uint8_t* data, size_t size, uint8_t* blocks) {
+    size_t pos = 0;
+    int filled = 0;
+    while (filled < CHUNK_CODEC_VOLUME) {
+        if (pos >= size) return false;
+        uint8_t block = data[pos++];
+
+        unsigned int run = 0;
+        for (int shift = 0; ; shift += 7) {
+            if (pos >= size || shift > 14) return false; // Runs never need more than 2 bytes
+            uint8_t b = data[pos++];
+            run |= (unsigned int)(b & 0x7F) << shift;
+            if (!(b & 0x80)) break;
+        }
+        if (run == 0 || run > (unsigned int)(CHUNK_CODEC_VOLUME - filled)) return false;
+
+        memset(blocks + filled, block, run);
+        filled += run;
+    }
+    return pos == size;
+}
+
+inline bool decodePalette(const uint8_t* data, size_t size, uint8_t* blocks) {
+    if (size < 1) return false;
+    size_t paletteSize = (size_t)data[0] + 1;
+    if (size < 1 + paletteSize) return false;
+    const uint8_t* palette = data + 1;
+
+    int bits = 0;
+    if (paletteSize > 16) bits = 8;
+    else if (paletteSize > 4) bits = 4;
+    else if (paletteSize > 2) bits = 2;
+    else if (paletteSize > 1) bits = 1;
+
+    const uint8_t* packed = palette + paletteSize;
+    if (size - 1 - paletteSize != (size_t)(CHUNK_CODEC_VOLUME * bits / 8)) return false;
+
+    if (bits == 0) {
+        memset(blocks, palette[0], CHUNK_CODEC_VOLUME);
+        return true;
+    }
+
+    // Unpack through a 256-entry table so a bad index can't read past the palette
+    uint8_t lookup[256] = {};
+    memcpy(lookup, palette, paletteSize);
+
+    int perByte = 8 / bits;
+    uint8_t mask = (uint8_t)((1 << bits) - 1);
+    bool valid = true;
+    for (int i = 0; i < CHUNK_CODEC_VOLUME; i += perByte) {
+        uint8_t byte = packed[i / perByte];
+        for (int j = 0; j < perByte; j++) {
+            uint8_t index = (byte >> (j * bits)) & mask;
+            valid &= index < paletteSize;
+            blocks[i + j] = lookup[index];
+        }
+    }
+    return valid;
+}
+
+// Fills `blocks` (4096 bytes) from encoded or legacy raw data. False if the data is
+// malformed or from a newer version; `blocks` may be partly written in that case.
+inline bool decodeChunk(const uint8_t* data, size_t size, uint8_t* blocks) {
+    if (size == (size_t)CHUNK_CODEC_VOLUME) {
+        // Headerless raw dump from before the codec
+        memcpy(blocks, data, CHUNK_CODEC_VOLUME);
+        return true;
+    }
+    if (size < 2 || data[0] != CHUNK_CODEC_VERSION) return false;
+
+    const uint8_t* payload = data + 2;
+    size_t payloadSize = size - 2;
+    switch (data[1]) {
+    case CODEC_RAW:
+        if (payloadSize != (size_t)CHUNK_CODEC_VOLUME) return false;
+        memcpy(blocks, payload, CHUNK_CODEC_VOLUME);
+        return true;
+    case CODEC_RLE:
+        return decodeRLE(payload, payloadSize, blocks);
+    case CODEC_PALETTE:
+        return decodePalette(payload, payloadSize, blocks);
+    default:
+        return false;
+    }
+}
+
+// === Columns ===
+// A chunk column is a stack of sections, each encoded as above:
+//
+//   [COLUMN_CODEC_VERSION][section count][per section: uint16 length, encoded section]
+//
+// Anything else is read as a single section (saves from before sections): it becomes
+// the bottom section and the rest is left as zero bytes (air). Like a section, an
+// encoded column is never exactly 4096 bytes, the size of a headerless old chunk.
+const int COLUMN_CODEC_VERSION = 2;
+
+// `blocks` is sectionCount * 4096 bytes, bottom section first
+inline void encodeColumn(const uint8_t* blocks, int sectionCount, std::vector<uint8_t>& out) {
+    out.clear();
+    out.push_back((uint8_t)COLUMN_CODEC_VERSION);
+    out.push_back((uint8_t)sectionCount);
+
+    std::vector<uint8_t> section;
+    for (int i = 0; i < sectionCount; i++) {
+        encodeChunk(blocks + i * CHUNK_CODEC_VOLUME, section);
+        out.push_back((uint8_t)(section.size() & 0xFF));
+        out.push_back((uint8_t)(section.size() >> 8));
+        out.insert(out.end(), section.begin(), section.end());
+    }
+
+    if (out.size() == (size_t)CHUNK_CODEC_VOLUME && sectionCount > 0) {
+        // Would read back as a headerless old save. Store the top section raw instead,
+        // which always makes the column longer.
+        out.resize(out.size() - section.size() - 2);
+        const uint8_t* top = blocks + (sectionCount - 1) * CHUNK_CODEC_VOLUME;
+        size_t rawSize = CHUNK_CODEC_VOLUME + 2;
+        out.push_back((uint8_t)(rawSize & 0xFF));
+        out.push_back((uint8_t)(rawSize >> 8));
+        out.push_back((uint8_t)CHUNK_CODEC_VERSION);
+        out.push_back(CODEC_RAW);
+        out.insert(out.end(), top, top + CHUNK_CODEC_VOLUME);
+    }
+}
+
+// False if the data is malformed or has more sections than sectionCount
+inline bool decodeColumn(const uint8_t* data, size_t size, uint8_t* blocks, int sectionCount) {
+    if (size == (size_t)CHUNK_CODEC_VOLUME || size < 2 || data[0] != COLUMN_CODEC_VERSION) {
+        // Single section from an older save
+        memset(blocks, 0, (size_t)sectionCount * CHUNK_CODEC_VOLUME);
+        return decodeChunk(data, size, blocks);
+    }
+
+    int stored = data[1];
+    if (stored > sectionCount) return false;
+    memset(blocks + (size_t)stored * CHUNK_CODEC_VOLUME, 0, (size_t)(sectionCount - stored) * CHUNK_CODEC_VOLUME);
+
+    size_t pos = 2;
+    for (int i = 0; i < stored; i++) {
+        if (size - pos < 2) return false;
+        size_t length = data[pos] | ((size_t)data[pos + 1] << 8);
+        pos += 2;
+        if (size - pos < length) return false;
+        if (!decodeChunk(data + pos, length, blocks + i * CHUNK_CODEC_VOLUME)) return false;
+        pos += length;
+    }
+    return pos == size;
+}
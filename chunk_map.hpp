@@ -0,0 +1,150 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <climits>
+#include <cstddef>
+
+// Hash map keyed on chunk coordinates (x, z), used for the world's chunk index.
+// Open addressing with linear probing in one flat array: a lookup is a hash and
+// usually a single cache line, instead of a tree walk through scattered nodes.
+// Erasing shifts the following entries back, so there are no tombstones.
+// Pointers to values are invalidated by insert() and erase().
+template <typename T>
+class ChunkMap {
+public:
+    struct Slot {
+        int x = EMPTY, z = EMPTY;
+        T value{};
+
+        bool used() const { return x != EMPTY || z != EMPTY; }
+    };
+
+    ChunkMap() {
+        slots.resize(MIN_CAPACITY);
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    // Pointer to the value stored for (x, z), or nullptr
+    T* find(int x, int z) {
+        size_t i = indexFor(x, z);
+        while (slots[i].used()) {
+            if (slots[i].x == x && slots[i].z == z) return &slots[i].value;
+            i = (i + 1) & mask();
+        }
+        return nullptr;
+    }
+
+    const T* find(int x, int z) const {
+        return const_cast<ChunkMap*>(this)->find(x, z);
+    }
+
+    bool contains(int x, int z) const {
+        return find(x, z) != nullptr;
+    }
+
+    // Inserts or overwrites
+    void insert(int x, int z, T value) {
+        if ((count + 1) * 2 > slots.size()) {
+            rehash(slots.size() * 2);
+        }
+
+        size_t i = indexFor(x, z);
+        while (slots[i].used()) {
+            if (slots[i].x == x && slots[i].z == z) {
+                slots[i].value = std::move(value);
+                return;
+            }
+            i = (i + 1) & mask();
+        }
+        slots[i].x = x;
+        slots[i].z = z;
+        slots[i].value = std::move(value);
+        count++;
+    }
+
+    // Returns false if (x, z) wasn't there
+    bool erase(int x, int z) {
+        size_t i = indexFor(x, z);
+        while (true) {
+            if (!slots[i].used()) return false;
+            if (slots[i].x == x && slots[i].z == z) break;
+            i = (i + 1) & mask();
+        }
+
+        // Backward shift: pull later entries of the probe run into the hole if
+        // the hole lies between their home slot and where they are now
+        size_t hole = i;
+        size_t j = i;
+        while (true) {
+            j = (j + 1) & mask();
+            if (!slots[j].used()) break;
+
+            size_t home = indexFor(slots[j].x, slots[j].z);
+            bool canMove = (hole <= j) ? (home <= hole || home > j) : (home <= hole && home > j);
+            if (canMove) {
+                slots[hole] = std::move(slots[j]);
+                hole = j;
+            }
+        }
+        slots[hole] = Slot();
+        count--;
+        return true;
+    }
+
+    void clear() {
+        slots.assign(MIN_CAPACITY, Slot());
+        count = 0;
+    }
+
+    // Iteration over the used slots. Don't insert/erase while iterating.
+    class iterator {
+    public:
+        iterator(Slot* slot, Slot* end) : slot(slot), end(end) { skip(); }
+        Slot& operator*() const { return *slot; }
+        Slot* operator->() const { return slot; }
+        iterator& operator++() { ++slot; skip(); return *this; }
+        bool operator!=(const iterator& other) const { return slot != other.slot; }
+        bool operator==(const iterator& other) const { return slot == other.slot; }
+    private:
+        Slot* slot;
+        Slot* end;
+        void skip() { while (slot != end && !slot->used()) ++slot; }
+    };
+
+    iterator begin() { return iterator(slots.data(), slots.data() + slots.size()); }
+    iterator end() { return iterator(slots.data() + slots.size(), slots.data() + slots.size()); }
+
+private:
+    // Marks an unused slot. No chunk is ever this far out.
+    static const int EMPTY = INT_MIN;
+    static const size_t MIN_CAPACITY = 64;
+
+    std::vector<Slot> slots; // Size is always a power of two, at most half full
+    size_t count = 0;
+
+    size_t mask() const { return slots.size() - 1; }
+
+    size_t indexFor(int x, int z) const {
+        uint64_t key = ((uint64_t)(uint32_t)x << 32) | (uint32_t)z;
+        // 64-bit mix (splitmix64 finalizer) so neighbouring chunks spread out
+        key ^= key >> 30;
+        key *= 0xbf58476d1ce4e5b9ULL;
+        key ^= key >> 27;
+        key *= 0x94d049bb133111ebULL;
+        key ^= key >> 31;
+        return (size_t)key & mask();
+    }
+
+    void rehash(size_t newCapacity) {
+        std::vector<Slot> old;
+        old.swap(slots);
+        slots.resize(newCapacity);
+        count = 0;
+        for (Slot& s : old) {
+            if (s.used()) insert(s.x, s.z, std::move(s.value));
+        }
+    }
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// Uniform buffer binding of the FrameData block (see shaders/vertex.glsl)
+const int FRAME_UNIFORMS_BINDING = 0;
+
+// Everything the shaders need that changes per frame, not per draw. Matches the
+// std140 FrameData block: only mat4 and vec4 members, so there is no padding to get
+// wrong (a vec3 would take 16 bytes in the shader but 12 here).
+struct FrameUniforms {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::vec4 viewPos;        // xyz
+    glm::vec4 fog;            // rgb = color, a = density
+    glm::vec4 lightDirection; // xyz
+    glm::vec4 lightAmbient;   // rgb
+    glm::vec4 lightDiffuse;   // rgb
+};
+static_assert(sizeof(FrameUniforms) == 2 * 64 + 5 * 16, "FrameUniforms must match the std140 FrameData block");
+
+// The uniform buffer behind FrameData. Every program that declares the block reads it
+// from FRAME_UNIFORMS_BINDING, so one upload per frame replaces setting the same
+// uniforms on each program.
+class FrameUniformBuffer {
+public:
+    // Uploads this frame's values (needs a current GL context)
+    void update(const FrameUniforms& values) {
+        if (UBO == 0) {
+            glGenBuffers(1, &UBO);
+            glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+            glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), nullptr, GL_DYNAMIC_DRAW);
+            glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_UNIFORMS_BINDING, UBO);
+        }
+        glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniforms), &values);
+    }
+
+private:
+    unsigned int UBO = 0;
+};
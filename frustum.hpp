@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cmath>
+#include <glm/glm.hpp>
+
+// View frustum as 6 planes (ax + by + cz + d >= 0 inside), extracted from a
+// projection * view matrix. Used to skip chunks the camera can't see.
+struct Frustum {
+    glm::vec4 planes[6]; // Left, right, bottom, top, near, far
+
+    // Gribb/Hartmann plane extraction. glm matrices are column-major, so row i is
+    // (m[0][i], m[1][i], m[2][i], m[3][i]).
+    static Frustum fromMatrix(const glm::mat4& m) {
+        glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+        glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+        glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+        glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+        Frustum f;
+        f.planes[0] = row3 + row0;
+        f.planes[1] = row3 - row0;
+        f.planes[2] = row3 + row1;
+        f.planes[3] = row3 - row1;
+        f.planes[4] = row3 + row2;
+        f.planes[5] = row3 - row2;
+        return f;
+    }
+
+    // False only if the box is completely outside one of the planes. Boxes near a
+    // corner of the frustum can pass without being visible, which is fine for culling.
+    bool intersectsBox(const glm::vec3& boxMin, const glm::vec3& boxMax) const {
+        for (const glm::vec4& p : planes) {
+            // The box corner furthest along the plane normal
+            glm::vec3 corner(p.x >= 0.0f ? boxMax.x : boxMin.x,
+                             p.y >= 0.0f ? boxMax.y : boxMin.y,
+                             p.z >= 0.0f ? boxMax.z : boxMin.z);
+            if (p.x * corner.x + p.y * corner.y + p.z * corner.z + p.w < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
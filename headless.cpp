@@ -0,0 +1,53 @@
+// Headless run of the voxel core: streams the world around a camera flying in a
+// straight line, no window or GL. Meshes are still built on the workers, the default
+// MeshUploader only counts them. Handy for checking the core on a server / in CI and
+// for profiling the pipeline without the renderer.
+//   ./cubeblock_headless [frames]
+
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include <iostream>
+
+#include "world.hpp"
+#include "physics.hpp"
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? std::atoi(argv[1]) : 600;
+
+    globalBlockManager.loadBlocks("blocks.json");
+
+    World world;
+    world.isInfinite = true;
+
+    // Just above the terrain
+    glm::vec3 pos(8.0f, 40.0f, 8.0f);
+    const glm::vec3 dir(1.0f, 0.0f, 0.0f);
+    const glm::vec3 velocity = dir * 20.0f; // Blocks per second, at 60 frames per second
+
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        world.update(pos, dir, velocity);
+        pos += velocity / 60.0f;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    RaycastResult ground = raycast(world, pos, glm::vec3(0.0f, -1.0f, 0.0f), 200.0f);
+    std::cout << frames << " frames in " << seconds << " s"
+        << " | Chunks: " << world.activeChunks.size()
+        << " | Vertices: " << world.totalVertexCount()
+        << " | Queued jobs: " << world.queuedJobs() << std::endl;
+    if (ground.hit) {
+        glm::vec3 feet(pos.x, ground.blockPos.y + 1.0f, pos.z);
+        std::cout << "Ground below at y=" << ground.blockPos.y
+            << ", standing on it collides: " << (checkCollision(world, feet + glm::vec3(0.0f, 1.8f, 0.0f), 0.6f, 1.8f) ? "yes" : "no")
+            << ", sunk into it: " << (checkCollision(world, feet + glm::vec3(0.0f, 1.0f, 0.0f), 0.6f, 1.8f) ? "yes" : "no") << std::endl;
+    }
+    else {
+        std::cout << "No ground below " << pos.y << std::endl;
+    }
+
+    world.shutdown();
+    return 0;
+}
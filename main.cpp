@@ -1,5 +1,4 @@
 #define STB_IMAGE_IMPLEMENTATION
-#define STB_PERLIN_IMPLEMENTATION
 
 #include <fstream>
 #include <sstream>
@@ -14,10 +13,14 @@
 #include <nlohmann/json.hpp>
 
 #include "stb_image.h"
-#include "stb_perlin.h"
 #include "shader_s.hpp"
+#include "frame_uniforms.hpp"
+#include "profiler_gl.hpp"
 #include "block_manager.hpp"
 #include "world.hpp"
+#include "world_renderer.hpp"
+#include "physics.hpp"
+#include "block_textures.hpp"
 
 using json = nlohmann::json;
 
@@ -49,6 +52,7 @@ const float cameraSpeed = 0.05f;
 glm::vec3 cameraPos = glm::vec3(0.0f, 10.0f, 3.0f);
 glm::vec3 cameraFront = glm::vec3(0.0f, 0.0f, -1.0f);
 glm::vec3 cameraUp = glm::vec3(0.0f, 1.0f, 0.0f);
+glm::vec3 lastCameraPos = cameraPos;
 
 bool firstMouse = true;
 float yaw = -90.0f;
@@ -59,12 +63,16 @@ float lastY = windowHeight / 2.0;
 float lastModifyTime = 0.0f;
 float lastAutoSaveTime = 0.0f;
 
+// Window title stats (FPS + chunk culling counters)
+float lastTitleUpdate = 0.0f;
+int framesSinceTitleUpdate = 0;
+
 unsigned int highlightVAO = 0, highlightVBO = 0;
 unsigned int chVAO, chVBO;
 
-// Global Managers
-BlockManager globalBlockManager;
+// Global Managers (globalBlockManager lives in block_manager.cpp)
 World world;
+WorldRenderer worldRenderer;
 
 // =======================
 // === Shader Sources ===
@@ -75,8 +83,16 @@ const char* highlightVert = R"(
     #version 460 core
     layout (location = 0) in vec3 aPos;
     uniform mat4 model;
-    uniform mat4 view;
-    uniform mat4 projection;
+    // Only view and projection are read, the block must match frame_uniforms.hpp all the same
+    layout (std140, binding = 0) uniform FrameData {
+        mat4 view;
+        mat4 projection;
+        vec4 viewPos;
+        vec4 fog;
+        vec4 lightDirection;
+        vec4 lightAmbient;
+        vec4 lightDiffuse;
+    };
     void main() {
         gl_Position = projection * view * model * vec4(aPos, 1.0);
     }
@@ -153,78 +169,6 @@ unsigned int loadTexture(const char* path) {
     return textureID;
 }
 
-struct RaycastResult {
-    bool hit;
-    glm::ivec3 blockPos;
-    glm::vec3 worldPos;
-    glm::ivec3 normal; // Stores which face we hit
-};
-
-RaycastResult raycast(glm::vec3 start, glm::vec3 direction, float range) {
-    glm::vec3 dir = glm::normalize(direction);
-    glm::ivec3 mapPos = glm::floor(start);
-
-    glm::vec3 deltaDist = glm::abs(1.0f / dir);
-    glm::ivec3 step;
-    glm::vec3 sideDist;
-
-    // Track the last axis we moved on to calculate normal
-    int lastAxis = -1; // 0=x, 1=y, 2=z
-
-    if (dir.x < 0) { step.x = -1; sideDist.x = (start.x - mapPos.x) * deltaDist.x; }
-    else { step.x = 1;  sideDist.x = (mapPos.x + 1.0f - start.x) * deltaDist.x; }
-
-    if (dir.y < 0) { step.y = -1; sideDist.y = (start.y - mapPos.y) * deltaDist.y; }
-    else { step.y = 1;  sideDist.y = (mapPos.y + 1.0f - start.y) * deltaDist.y; }
-
-    if (dir.z < 0) { step.z = -1; sideDist.z = (start.z - mapPos.z) * deltaDist.z; }
-    else { step.z = 1;  sideDist.z = (mapPos.z + 1.0f - start.z) * deltaDist.z; }
-
-    float dist = 0.0f;
-    while (dist < range) {
-        if (sideDist.x < sideDist.y) {
-            if (sideDist.x < sideDist.z) {
-                mapPos.x += step.x;
-                dist = sideDist.x;
-                sideDist.x += deltaDist.x;
-                lastAxis = 0;
-            }
-            else {
-                mapPos.z += step.z;
-                dist = sideDist.z;
-                sideDist.z += deltaDist.z;
-                lastAxis = 2;
-            }
-        }
-        else {
-            if (sideDist.y < sideDist.z) {
-                mapPos.y += step.y;
-                dist = sideDist.y;
-                sideDist.y += deltaDist.y;
-                lastAxis = 1;
-            }
-            else {
-                mapPos.z += step.z;
-                dist = sideDist.z;
-                sideDist.z += deltaDist.z;
-                lastAxis = 2;
-            }
-        }
-
-        BlockID b = world.getBlock(mapPos.x, mapPos.y, mapPos.z);
-        if (b != BLOCK_AIR) {
-            // Calculate Normal based on the last step taken
-            glm::ivec3 normal(0);
-            if (lastAxis == 0) normal.x = -step.x;
-            if (lastAxis == 1) normal.y = -step.y;
-            if (lastAxis == 2) normal.z = -step.z;
-
-            return { true, mapPos, start + dir * dist, normal };
-        }
-    }
-    return { false, glm::ivec3(0), glm::vec3(0), glm::ivec3(0) };
-}
-
 // ========================
 // === Input Callbacks ===
 // ========================
@@ -274,38 +218,17 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset) {
     if (fov > 90.0f) fov = 90.0f;
 }
 
-bool checkCollision(glm::vec3 pos) {
-    // Define Player Bounding Box
-    // Eyes are at pos.y. Feet are at pos.y - PLAYER_HEIGHT
-    float minX = pos.x - PLAYER_WIDTH / 2.0f;
-    float maxX = pos.x + PLAYER_WIDTH / 2.0f;
-    float minY = pos.y - PLAYER_HEIGHT;
-    float maxY = pos.y + 0.1f; // Small buffer above head
-    float minZ = pos.z - PLAYER_WIDTH / 2.0f;
-    float maxZ = pos.z + PLAYER_WIDTH / 2.0f;
-
-    // Check every integer block coordinate inside this box
-    // We floor/ceil to get the range of blocks we are touching
-    int startX = (int)floor(minX);
-    int endX = (int)floor(maxX);
-    int startY = (int)floor(minY);
-    int endY = (int)floor(maxY);
-    int startZ = (int)floor(minZ);
-    int endZ = (int)floor(maxZ);
-
-    for (int y = startY; y <= endY; y++) {
-        for (int x = startX; x <= endX; x++) {
-            for (int z = startZ; z <= endZ; z++) {
-                if (world.getBlock(x, y, z) != BLOCK_AIR) {
-                    return true; // Collision detected
-                }
-            }
-        }
-    }
-    return false;
-}
-
 bool gKeyPressed = false;
+bool mKeyPressed = false;
+bool f3KeyPressed = false;
+bool f4KeyPressed = false;
+bool f5KeyPressed = false;
+
+// Profiler overlay (F3) and CSV recording (F4)
+bool showProfiler = false;
+const char* profilerCsvPath = "profile.csv";
+// Chunk pipeline trace (F5), see trace.hpp
+const char* tracePath = "trace.json";
 
 void processInput(GLFWwindow* window) {
     // === Mode Toggling ===
@@ -322,6 +245,70 @@ void processInput(GLFWwindow* window) {
         gKeyPressed = false;
     }
 
+    // === Mesher Toggling (A/B naive vs greedy) ===
+    if (glfwGetKey(window, GLFW_KEY_M) == GLFW_PRESS) {
+        if (!mKeyPressed) {
+            mKeyPressed = true;
+            bool greedy = Chunk::meshingMode != MeshingMode::Greedy;
+            Chunk::meshingMode = greedy ? MeshingMode::Greedy : MeshingMode::Naive;
+
+            double start = glfwGetTime();
+            world.remeshAll();
+            double elapsedMs = (glfwGetTime() - start) * 1000.0;
+
+            std::cout << "Mesher: " << (greedy ? "GREEDY" : "NAIVE")
+                << " | Chunks: " << world.activeChunks.size()
+                << " | Vertices: " << world.totalVertexCount()
+                << " | Remesh: " << elapsedMs << " ms" << std::endl;
+        }
+    }
+    else {
+        mKeyPressed = false;
+    }
+
+    // === Profiler ===
+    if (glfwGetKey(window, GLFW_KEY_F3) == GLFW_PRESS) {
+        if (!f3KeyPressed) {
+            f3KeyPressed = true;
+            showProfiler = !showProfiler;
+        }
+    }
+    else {
+        f3KeyPressed = false;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_F4) == GLFW_PRESS) {
+        if (!f4KeyPressed) {
+            f4KeyPressed = true;
+            if (Profiler::isRecording()) {
+                Profiler::stopRecording(profilerCsvPath);
+            }
+            else {
+                Profiler::startRecording();
+                std::cout << "Profiler: recording frames, F4 again to write " << profilerCsvPath << std::endl;
+            }
+        }
+    }
+    else {
+        f4KeyPressed = false;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_F5) == GLFW_PRESS) {
+        if (!f5KeyPressed) {
+            f5KeyPressed = true;
+            if (Trace::isEnabled()) {
+                Trace::stop(tracePath);
+            }
+            else {
+                Trace::start();
+                std::cout << "Trace: recording chunk activity, F5 again to write " << tracePath << std::endl;
+            }
+        }
+    }
+    else {
+        f5KeyPressed = false;
+    }
+
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) glfwSetWindowShouldClose(window, true);
     if (glfwGetKey(window, GLFW_KEY_I) == GLFW_PRESS) world.isInfinite = !world.isInfinite;
 
@@ -354,13 +341,13 @@ void processInput(GLFWwindow* window) {
     else {
         // Horizontal Collision (X axis)
         if (moveDir.x != 0.0f) {
-            if (!checkCollision(cameraPos + glm::vec3(moveDir.x, 0.0f, 0.0f))) {
+            if (!checkCollision(world, cameraPos + glm::vec3(moveDir.x, 0.0f, 0.0f), PLAYER_WIDTH, PLAYER_HEIGHT)) {
                 cameraPos.x += moveDir.x;
             }
         }
         // Horizontal Collision (Z axis)
         if (moveDir.z != 0.0f) {
-            if (!checkCollision(cameraPos + glm::vec3(0.0f, 0.0f, moveDir.z))) {
+            if (!checkCollision(world, cameraPos + glm::vec3(0.0f, 0.0f, moveDir.z), PLAYER_WIDTH, PLAYER_HEIGHT)) {
                 cameraPos.z += moveDir.z;
             }
         }
@@ -375,7 +362,7 @@ void processInput(GLFWwindow* window) {
         // Vertical Collision (Y axis)
         float verticalMove = playerVerticalVelocity * deltaTime;
 
-        if (checkCollision(cameraPos + glm::vec3(0.0f, verticalMove, 0.0f))) {
+        if (checkCollision(world, cameraPos + glm::vec3(0.0f, verticalMove, 0.0f), PLAYER_WIDTH, PLAYER_HEIGHT)) {
             // If moving down (falling) and hit something -> Landed
             if (verticalMove < 0.0f) {
                 isGrounded = true;
@@ -401,7 +388,9 @@ void processInput(GLFWwindow* window) {
         bool rightClick = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS;
 
         if (leftClick || rightClick) {
-            RaycastResult ray = raycast(cameraPos, cameraFront, 8.0f);
+            ProfileZone raycastZone("raycast");
+            RaycastResult ray = raycast(world, cameraPos, cameraFront, 8.0f);
+            raycastZone.end();
             if (ray.hit) {
                 if (rightClick) {
                     glm::ivec3 p = ray.blockPos + ray.normal;
@@ -482,6 +471,11 @@ int main()
     glAttachShader(crosshairProg, chFrag);
     glLinkProgram(crosshairProg);
 
+    // Looked up once here rather than every frame
+    GLint highlightModelLoc = glGetUniformLocation(highlightProg, "model");
+    GLint crosshairScaleLoc = glGetUniformLocation(crosshairProg, "scale");
+    GLint crosshairAspectLoc = glGetUniformLocation(crosshairProg, "aspectRatio");
+
     Shader ourShader("shaders/vertex.glsl", "shaders/fragment.glsl");
 
     // ============================
@@ -541,6 +535,7 @@ int main()
 
     // Load textures from json file
     globalBlockManager.loadBlocks("blocks.json");
+    unsigned int blockTextureArray = loadBlockTextureArray(globalBlockManager.texturePaths);
 
     // Load Texture
     unsigned int crosshairTexture = loadTexture("textures/crosshair.png"); // Make sure this file exists!
@@ -548,12 +543,22 @@ int main()
     // Configure Shader
     ourShader.use();
     ourShader.setInt("textureArray", 0);
-    ourShader.setVec3("light.direction", -0.2f, -1.0f, -0.3f);
-    ourShader.setVec3("light.ambient", 0.2f, 0.2f, 0.2f);
-    ourShader.setVec3("light.diffuse", 0.8f, 0.8f, 0.8f);
+
+    // View, projection, fog and light go to every program through one uniform buffer
+    FrameUniformBuffer frameUniformBuffer;
+    FrameUniforms frameUniforms;
+    frameUniforms.lightDirection = glm::vec4(-0.2f, -1.0f, -0.3f, 0.0f);
+    frameUniforms.lightAmbient = glm::vec4(0.2f, 0.2f, 0.2f, 0.0f);
+    frameUniforms.lightDiffuse = glm::vec4(0.8f, 0.8f, 0.8f, 0.0f);
+
+    // Profiling (see profiler.hpp)
+    GpuTimer worldGpuTimer("world");
+    GpuTimer overlayGpuTimer("highlight + ui");
+    ProfilerOverlay profilerOverlay;
 
     // World Settings
     world.isInfinite = true;
+    world.meshUploader = std::make_unique<ArenaMeshUploader>(); // Meshes go to the GPU
 
     // ============================
     // === Render Loop          ===
@@ -564,6 +569,8 @@ int main()
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
+        Profiler::beginFrame();
+        ProfileZone zone("processInput");
         processInput(window);
 
         glClearColor(0.5f, 0.81f, 0.92f, 1.0f); // Sky Blue Color
@@ -573,51 +580,59 @@ int main()
         glm::mat4 projection = glm::perspective(glm::radians(fov), (float)windowWidth / (float)windowHeight, 0.1f, 100.0f);
 
         // --- UPDATE WORLD ---
-        world.update(cameraPos);
-
-        // --- RENDER WORLD ---
-        ourShader.use();
-        ourShader.setMat4("view", view);
-        ourShader.setMat4("projection", projection);
+        // Velocity only steers which chunks stream in first
+        glm::vec3 playerVelocity = deltaTime > 0.0f ? (cameraPos - lastCameraPos) / deltaTime : glm::vec3(0.0f);
+        lastCameraPos = cameraPos;
+        zone.next("World::update");
+        world.update(cameraPos, cameraFront, playerVelocity);
 
-        ourShader.setVec3("viewPos", cameraPos);
+        // --- FRAME UNIFORMS ---
+        frameUniforms.view = view;
+        frameUniforms.projection = projection;
+        frameUniforms.viewPos = glm::vec4(cameraPos, 1.0f);
 
         // === FOG SETTINGS ===
-        ourShader.setVec3("fogColor", 0.53f, 0.81f, 0.92f);
-
         // Calculate dynamic density based on Render Distance
         // Formula: density = 2.0 / MaxDistance. 
         // This ensures visibility drops to ~1.8% at the edge of the world.
         float maxDist = (float)(world.renderDistance * CHUNK_SIZE);
         float density = 2.4f / maxDist; // 2.4 makes it slightly thicker to hide corners
+        frameUniforms.fog = glm::vec4(0.53f, 0.81f, 0.92f, density);
 
-        ourShader.setFloat("fogDensity", density);
+        frameUniformBuffer.update(frameUniforms);
+
+        // --- RENDER WORLD ---
+        ourShader.use();
 
         glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D_ARRAY, globalBlockManager.textureArrayID);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, blockTextureArray);
 
-        world.render(ourShader);
+        zone.next("World::render");
+        worldGpuTimer.begin();
+        worldRenderer.render(world, projection * view);
+        worldGpuTimer.end();
 
         // Auto-save
+        zone.next("autosave");
         if (currentFrame - lastAutoSaveTime > 60.0f) {
-            std::cout << "Auto-saving..." << std::endl;
+            std::cout << "Auto-saving..." << std::endl; // Queued, written in the background
             world.saveAllChunks();
             lastAutoSaveTime = currentFrame;
         }
 
         // Raycast
-        RaycastResult ray = raycast(cameraPos, cameraFront, 8.0f);
+        zone.next("highlight + ui");
+        overlayGpuTimer.begin();
+        ProfileZone raycastZone("raycast");
+        RaycastResult ray = raycast(world, cameraPos, cameraFront, 8.0f);
+        raycastZone.end();
 
         if (ray.hit) {
             // Enable Blending for transparency
             glEnable(GL_BLEND);
             glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-            glUseProgram(highlightProg);
-
-            // Set View/Proj
-            glUniformMatrix4fv(glGetUniformLocation(highlightProg, "view"), 1, GL_FALSE, glm::value_ptr(view));
-            glUniformMatrix4fv(glGetUniformLocation(highlightProg, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+            glUseProgram(highlightProg); // View/Proj come from the frame uniform buffer
 
             // Position the cube at the hit block
             glm::mat4 model = glm::mat4(1.0f);
@@ -628,7 +643,7 @@ int main()
             ));
             model = glm::scale(model, glm::vec3(1.01f));
 
-            glUniformMatrix4fv(glGetUniformLocation(highlightProg, "model"), 1, GL_FALSE, glm::value_ptr(model));
+            glUniformMatrix4fv(highlightModelLoc, 1, GL_FALSE, glm::value_ptr(model));
 
             glBindVertexArray(highlightVAO);
             glDrawArrays(GL_TRIANGLES, 0, 36);
@@ -640,18 +655,52 @@ int main()
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         glUseProgram(crosshairProg);
-        glUniform1f(glGetUniformLocation(crosshairProg, "scale"), 0.05f);
-        glUniform1f(glGetUniformLocation(crosshairProg, "aspectRatio"), (float)windowWidth / (float)windowHeight);
+        glUniform1f(crosshairScaleLoc, 0.05f);
+        glUniform1f(crosshairAspectLoc, (float)windowWidth / (float)windowHeight);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, crosshairTexture);
         glBindVertexArray(chVAO);
         glDrawArrays(GL_TRIANGLES, 0, 6);
         glEnable(GL_DEPTH_TEST);
+        overlayGpuTimer.end();
+
+        if (showProfiler) {
+            zone.next("profiler overlay");
+            profilerOverlay.draw((int)windowWidth, (int)windowHeight);
+        }
+        zone.end();
+
+        // Stats in the window title, twice a second
+        framesSinceTitleUpdate++;
+        if (currentFrame - lastTitleUpdate > 0.5f) {
+            float fps = framesSinceTitleUpdate / (currentFrame - lastTitleUpdate);
+            std::string title = std::string(windowTitle)
+                + " | FPS: " + std::to_string((int)fps)
+                + " | Sections drawn: " + std::to_string(world.renderStats.drawn)
+                + " / tested: " + std::to_string(world.renderStats.tested)
+                + " (culled: " + std::to_string(world.renderStats.culled) + ")";
+            glfwSetWindowTitle(window, title.c_str());
+            lastTitleUpdate = currentFrame;
+            framesSinceTitleUpdate = 0;
+        }
 
-        world.saveAllChunks();
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        {
+            ProfileZone swapZone("swap buffers"); // Includes waiting for vsync
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+        }
+        Profiler::endFrame();
     }
+    // Write out everything that's still unsaved
+    world.shutdown();
+    if (Trace::isEnabled()) Trace::stop(tracePath);
+    if (Profiler::isRecording()) Profiler::stopRecording(profilerCsvPath);
+
+    // Their destructors would run after the context is gone
+    worldGpuTimer.release();
+    overlayGpuTimer.release();
+    profilerOverlay.release();
+
     glfwTerminate();
     return 0;
 }
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cmath>
+#include <glm/glm.hpp>
+
+#include "world.hpp"
+
+// Gameplay queries against the world's blocks: what the player looks at, and whether
+// a box would overlap something. Only reads blocks through World::getBlock, so they
+// run headless as well.
+
+struct RaycastResult {
+    bool hit;
+    glm::ivec3 blockPos;
+    glm::vec3 worldPos;
+    glm::ivec3 normal; // Stores which face we hit
+};
+
+// Walks the block grid along the ray (DDA) up to `range` blocks and stops at the
+// first solid block
+inline RaycastResult raycast(World& world, glm::vec3 start, glm::vec3 direction, float range) {
+    glm::vec3 dir = glm::normalize(direction);
+    glm::ivec3 mapPos = glm::floor(start);
+
+    glm::vec3 deltaDist = glm::abs(1.0f / dir);
+    glm::ivec3 step;
+    glm::vec3 sideDist;
+
+    // Track the last axis we moved on to calculate normal
+    int lastAxis = -1; // 0=x, 1=y, 2=z
+
+    if (dir.x < 0) { step.x = -1; sideDist.x = (start.x - mapPos.x) * deltaDist.x; }
+    else { step.x = 1;  sideDist.x = (mapPos.x + 1.0f - start.x) * deltaDist.x; }
+
+    if (dir.y < 0) { step.y = -1; sideDist.y = (start.y - mapPos.y) * deltaDist.y; }
+    else { step.y = 1;  sideDist.y = (mapPos.y + 1.0f - start.y) * deltaDist.y; }
+
+    if (dir.z < 0) { step.z = -1; sideDist.z = (start.z - mapPos.z) * deltaDist.z; }
+    else { step.z = 1;  sideDist.z = (mapPos.z + 1.0f - start.z) * deltaDist.z; }
+
+    float dist = 0.0f;
+    while (dist < range) {
+        if (sideDist.x < sideDist.y) {
+            if (sideDist.x < sideDist.z) {
+                mapPos.x += step.x;
+                dist = sideDist.x;
+                sideDist.x += deltaDist.x;
+                lastAxis = 0;
+            }
+            else {
+                mapPos.z += step.z;
+                dist = sideDist.z;
+                sideDist.z += deltaDist.z;
+                lastAxis = 2;
+            }
+        }
+        else {
+            if (sideDist.y < sideDist.z) {
+                mapPos.y += step.y;
+                dist = sideDist.y;
+                sideDist.y += deltaDist.y;
+                lastAxis = 1;
+            }
+            else {
+                mapPos.z += step.z;
+                dist = sideDist.z;
+                sideDist.z += deltaDist.z;
+                lastAxis = 2;
+            }
+        }
+
+        BlockID b = world.getBlock(mapPos.x, mapPos.y, mapPos.z);
+        if (globalBlockManager.get(b).isSolid()) {
+            // Calculate Normal based on the last step taken
+            glm::ivec3 normal(0);
+            if (lastAxis == 0) normal.x = -step.x;
+            if (lastAxis == 1) normal.y = -step.y;
+            if (lastAxis == 2) normal.z = -step.z;
+
+            return { true, mapPos, start + dir * dist, normal };
+        }
+    }
+    return { false, glm::ivec3(0), glm::vec3(0), glm::ivec3(0) };
+}
+
+// Whether a player-shaped box touches a collidable block. `pos` is the eye position:
+// the box reaches `height` below it (and a little above), `width` across.
+inline bool checkCollision(World& world, glm::vec3 pos, float width, float height) {
+    // Define Player Bounding Box
+    // Eyes are at pos.y. Feet are at pos.y - height
+    float minX = pos.x - width / 2.0f;
+    float maxX = pos.x + width / 2.0f;
+    float minY = pos.y - height;
+    float maxY = pos.y + 0.1f; // Small buffer above head
+    float minZ = pos.z - width / 2.0f;
+    float maxZ = pos.z + width / 2.0f;
+
+    // Check every integer block coordinate inside this box
+    // We floor/ceil to get the range of blocks we are touching
+    int startX = (int)floor(minX);
+    int endX = (int)floor(maxX);
+    int startY = (int)floor(minY);
+    int endY = (int)floor(maxY);
+    int startZ = (int)floor(minZ);
+    int endZ = (int)floor(maxZ);
+
+    for (int y = startY; y <= endY; y++) {
+        for (int x = startX; x <= endX; x++) {
+            for (int z = startZ; z <= endZ; z++) {
+                if (globalBlockManager.get(world.getBlock(x, y, z)).isCollidable()) {
+                    return true; // Collision detected
+                }
+            }
+        }
+    }
+    return false;
+}
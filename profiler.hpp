@@ -0,0 +1,303 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+// Frame profiler: time spent per frame in named zones, kept for the last HISTORY frames
+// (for the p50/p99/max of the overlay in profiler_gl.hpp) and optionally recorded for a
+// per-frame CSV.
+//
+// ProfileZones on the main thread nest: a zone opened inside another one is its child,
+// "frame/World::update/unload". The same zone on a worker thread can't nest into the
+// main thread's frame, so its time is summed per frame under "workers" instead (CPU
+// time over all workers, which can add up to more than the frame). GPU times come in
+// the same way through addSample(), under "gpu".
+// Meant for coarse zones, each one costs two clock reads and a lookup.
+class Profiler {
+public:
+    static const int HISTORY = 240; // Frames, 4 s at 60 fps
+
+    struct Zone {
+        std::string name;
+        std::string path;   // Names from the root down, joined with '/'
+        int parent = -1;
+        int depth = 0;
+        double frameMs = 0; // This frame so far
+        float history[HISTORY] = {};
+    };
+
+    struct Stats {
+        float p50 = 0;
+        float p99 = 0;
+        float max = 0;
+    };
+
+    // Off: zones cost an atomic load and nothing is recorded. Takes effect at the
+    // next beginFrame().
+    static inline std::atomic<bool> enabled{ true };
+
+    // Opens the root "frame" zone. Call on the main thread, it's the one zones nest on.
+    static void beginFrame() {
+        frameActive = enabled.load();
+        if (!frameActive) return;
+        mainThread = std::this_thread::get_id();
+        if (zones.empty()) addZone(-1, "frame");
+        for (Zone& zone : zones) zone.frameMs = 0;
+        stack.clear();
+        frameStart = Clock::now();
+    }
+
+    // Closes the frame: takes in worker and GPU samples, then stores every zone's time
+    // in the history (0 for zones that didn't run) and the CSV recording
+    static void endFrame() {
+        if (!frameActive) return;
+        frameActive = false;
+        zones[0].frameMs = elapsedMs(frameStart);
+
+        std::vector<Sample> samples;
+        {
+            std::lock_guard<std::mutex> lock(samplesMutex);
+            samples.swap(pendingSamples);
+        }
+        for (const Sample& sample : samples) {
+            int group = findOrAddZone(-1, sample.group);
+            zones[findOrAddZone(group, sample.name)].frameMs += sample.ms;
+        }
+        for (const Zone& zone : zones) {
+            // Groups hold no time of their own, show the sum of their zones
+            if (zone.parent >= 0 && zones[zone.parent].parent < 0 && zone.parent != 0) {
+                zones[zone.parent].frameMs += zone.frameMs;
+            }
+        }
+
+        for (Zone& zone : zones) {
+            zone.history[historyPos] = (float)zone.frameMs;
+        }
+        historyPos = (historyPos + 1) % HISTORY;
+        recordedFrames = std::min(recordedFrames + 1, HISTORY);
+
+        if (recording) {
+            std::vector<float> row(zones.size());
+            for (size_t i = 0; i < zones.size(); i++) row[i] = (float)zones[i].frameMs;
+            csvRows.push_back(std::move(row));
+        }
+        frameCount++;
+    }
+
+    // Zones ever seen, parents before their children
+    static const std::vector<Zone>& allZones() {
+        return zones;
+    }
+
+    // Over the frames in the history
+    static Stats stats(int zone) {
+        Stats result;
+        if (recordedFrames == 0) return result;
+        std::vector<float> values(zones[zone].history, zones[zone].history + recordedFrames);
+        std::sort(values.begin(), values.end());
+        result.p50 = values[values.size() / 2];
+        result.p99 = values[std::min(values.size() - 1, values.size() * 99 / 100)];
+        result.max = values.back();
+        return result;
+    }
+
+    // Frames completed since startup
+    static long long frames() {
+        return frameCount;
+    }
+
+    // Adds time to zone `name` of top-level group `group` for the current frame. Any
+    // thread; both must be string literals (or outlive the profiler). Dropped when no
+    // frame is open, so programs without a frame loop (headless, benchmarks) keep nothing.
+    static void addSample(const char* group, const char* name, double ms) {
+        if (!enabled || !frameActive) return;
+        std::lock_guard<std::mutex> lock(samplesMutex);
+        pendingSamples.push_back({ group, name, ms });
+    }
+
+    static bool isMainThread() {
+        return std::this_thread::get_id() == mainThread.load();
+    }
+
+    // === CSV ===
+    // One row per frame, one column per zone in milliseconds. Rows are kept in memory
+    // and written by stopRecording(), so zones first seen halfway still get a column.
+
+    static bool isRecording() {
+        return recording;
+    }
+
+    static size_t recordedRows() {
+        return csvRows.size();
+    }
+
+    static void startRecording() {
+        csvRows.clear();
+        recordStart = frameCount;
+        recording = true;
+    }
+
+    static bool stopRecording(const std::string& path) {
+        recording = false;
+        std::ofstream file(path);
+        if (!file) {
+            std::cout << "Profiler: can't write " << path << std::endl;
+            csvRows.clear();
+            return false;
+        }
+
+        file << "frame_number";
+        for (const Zone& zone : zones) file << "," << zone.path;
+        file << "\n";
+        char value[32];
+        for (size_t r = 0; r < csvRows.size(); r++) {
+            file << recordStart + (long long)r;
+            for (size_t i = 0; i < zones.size(); i++) {
+                snprintf(value, sizeof(value), ",%.3f", i < csvRows[r].size() ? csvRows[r][i] : 0.0f);
+                file << value;
+            }
+            file << "\n";
+        }
+        std::cout << "Profiler: wrote " << csvRows.size() << " frames to " << path << std::endl;
+        csvRows.clear();
+        return true;
+    }
+
+private:
+    friend class ProfileZone;
+    using Clock = std::chrono::steady_clock;
+
+    struct Sample {
+        const char* group;
+        const char* name;
+        double ms;
+    };
+
+    struct OpenZone {
+        int zone;
+        Clock::time_point start;
+    };
+
+    static inline std::vector<Zone> zones;
+    static inline std::vector<OpenZone> stack;
+    static inline std::atomic<bool> frameActive{ false }; // Between beginFrame() and endFrame()
+    static inline Clock::time_point frameStart;
+    static inline std::atomic<std::thread::id> mainThread{};
+    static inline int historyPos = 0;
+    static inline int recordedFrames = 0;
+    static inline long long frameCount = 0;
+
+    static inline std::mutex samplesMutex;
+    static inline std::vector<Sample> pendingSamples;
+
+    static inline bool recording = false;
+    static inline long long recordStart = 0;
+    static inline std::vector<std::vector<float>> csvRows;
+
+    static double elapsedMs(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    static int addZone(int parent, const char* name) {
+        Zone zone;
+        zone.name = name;
+        zone.parent = parent;
+        zone.depth = parent < 0 ? 0 : zones[parent].depth + 1;
+        zone.path = parent < 0 ? zone.name : zones[parent].path + "/" + zone.name;
+        zones.push_back(std::move(zone));
+        return (int)zones.size() - 1;
+    }
+
+    static int findOrAddZone(int parent, const char* name) {
+        for (size_t i = 0; i < zones.size(); i++) {
+            if (zones[i].parent == parent && zones[i].name == name) return (int)i;
+        }
+        return addZone(parent, name);
+    }
+
+    // Main thread only. Returns the zone's position on the stack, for leave().
+    static int enter(const char* name) {
+        int parent = stack.empty() ? 0 : stack.back().zone;
+        stack.push_back({ findOrAddZone(parent, name), Clock::now() });
+        return (int)stack.size() - 1;
+    }
+
+    // Closes the zone that enter() put at `depth` during frame `frame`, and any zone
+    // still open above it. Does nothing if that zone isn't open any more, e.g. when
+    // it was opened before the current frame began.
+    static void leave(int depth, int zone, long long frame) {
+        if (frame != frameCount || depth >= (int)stack.size() || stack[depth].zone != zone) return;
+        while ((int)stack.size() > depth) {
+            zones[stack.back().zone].frameMs += elapsedMs(stack.back().start);
+            stack.pop_back();
+        }
+    }
+};
+
+// Times its scope as a profiler zone. next() ends it and starts a sibling, so the
+// phases of a long function can be timed without wrapping each one in braces:
+//
+//   ProfileZone phase("load");
+//   ...
+//   phase.next("mesh");
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name) {
+        begin(name);
+    }
+
+    ~ProfileZone() {
+        end();
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+    void next(const char* nextName) {
+        end();
+        begin(nextName);
+    }
+
+    void end() {
+        if (!name) return;
+        if (onMainThread) {
+            Profiler::leave(depth, zone, frame);
+        }
+        else {
+            Profiler::addSample("workers", name, Profiler::elapsedMs(start));
+        }
+        name = nullptr;
+    }
+
+private:
+    const char* name = nullptr;
+    bool onMainThread = false;
+    Profiler::Clock::time_point start;  // Worker zones
+    int depth = 0, zone = 0;            // Main thread zones: where enter() put it
+    long long frame = 0;
+
+    void begin(const char* zoneName) {
+        if (!Profiler::enabled) return;
+        onMainThread = Profiler::isMainThread();
+        if (onMainThread) {
+            if (!Profiler::frameActive) return;
+            depth = Profiler::enter(zoneName);
+            zone = Profiler::stack[depth].zone;
+            frame = Profiler::frameCount;
+        }
+        else {
+            if (!Profiler::frameActive) return;
+            start = Profiler::Clock::now();
+        }
+        name = zoneName;
+    }
+};
@@ -0,0 +1,332 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <iostream>
+
+#include "profiler.hpp"
+
+// The GL side of the profiler: GPU timings and the on-screen overlay.
+
+// === GPU timing ===
+// Times the GL commands between begin() and end() with a GL_TIME_ELAPSED query and
+// reports them to the profiler under "gpu". Results are read FRAMES_IN_FLIGHT frames
+// later, once the GPU is surely done, so the timer never stalls the pipeline. Only one
+// GL_TIME_ELAPSED query can run at a time: GpuTimers must not overlap.
+class GpuTimer {
+public:
+    static const int FRAMES_IN_FLIGHT = 4;
+
+    // `name` must be a string literal (the profiler keeps the pointer)
+    explicit GpuTimer(const char* name) : name(name) {}
+
+    ~GpuTimer() {
+        release();
+    }
+
+    // Deletes the queries. Call while the GL context is still alive if the timer
+    // outlives it; begin() creates them again.
+    void release() {
+        if (queries[0] == 0) return;
+        glDeleteQueries(FRAMES_IN_FLIGHT, queries);
+        for (int i = 0; i < FRAMES_IN_FLIGHT; i++) {
+            queries[i] = 0;
+            pending[i] = false;
+        }
+        running = false;
+    }
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    // Timer queries are core since GL 3.3
+    static bool supported() {
+        return GLAD_GL_VERSION_3_3 != 0;
+    }
+
+    void begin() {
+        running = false;
+        if (!Profiler::enabled || !supported()) return;
+        if (queries[0] == 0) glGenQueries(FRAMES_IN_FLIGHT, queries);
+
+        if (pending[slot]) {
+            GLint available = 0;
+            glGetQueryObjectiv(queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) return; // GPU more than FRAMES_IN_FLIGHT behind, skip a sample
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(queries[slot], GL_QUERY_RESULT, &nanoseconds);
+            Profiler::addSample("gpu", name, nanoseconds / 1e6);
+            pending[slot] = false;
+        }
+        glBeginQuery(GL_TIME_ELAPSED, queries[slot]);
+        running = true;
+    }
+
+    void end() {
+        if (!running) return;
+        glEndQuery(GL_TIME_ELAPSED);
+        pending[slot] = true;
+        slot = (slot + 1) % FRAMES_IN_FLIGHT;
+        running = false;
+    }
+
+private:
+    const char* name;
+    GLuint queries[FRAMES_IN_FLIGHT] = {};
+    bool pending[FRAMES_IN_FLIGHT] = {};
+    int slot = 0;
+    bool running = false;
+};
+
+// === Overlay ===
+// Every profiler zone with its p50/p99/max over the profiler's history, drawn in the
+// top left corner with a built-in 5x7 pixel font (upper case, digits and a little
+// punctuation). The text is rebuilt every REFRESH_FRAMES frames so it stays readable.
+class ProfilerOverlay {
+public:
+    static const int REFRESH_FRAMES = 15;
+    static const int PIXEL_SCALE = 2;   // Screen pixels per font pixel
+    static const int NAME_COLUMNS = 26; // Characters for the indented zone name
+
+    ~ProfilerOverlay() {
+        release();
+    }
+
+    // Deletes the GL objects, same as GpuTimer::release(); draw() creates them again
+    void release() {
+        if (VAO == 0) return;
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteProgram(program);
+        VAO = VBO = program = 0;
+    }
+
+    // Call after the scene is drawn. Leaves depth testing on and blending off.
+    void draw(int screenWidth, int screenHeight) {
+        if (VAO == 0) init();
+        if (vertices.empty() || Profiler::frames() - builtAt >= REFRESH_FRAMES) {
+            rebuild();
+            builtAt = Profiler::frames();
+        }
+        if (vertices.empty()) return;
+
+        glDisable(GL_DEPTH_TEST);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        glUseProgram(program);
+        glUniform2f(screenSizeLoc, (float)screenWidth, (float)screenHeight);
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(OverlayVertex), vertices.data(), GL_STREAM_DRAW);
+        glDrawArrays(GL_TRIANGLES, 0, (GLsizei)vertices.size());
+
+        glDisable(GL_BLEND);
+        glEnable(GL_DEPTH_TEST);
+    }
+
+private:
+    struct OverlayVertex {
+        float x, y; // Screen pixels, origin top left
+        float r, g, b, a;
+    };
+
+    struct Glyph {
+        char c;
+        uint8_t rows[7]; // Top row first, bit 4 is the leftmost pixel
+    };
+
+    static const int GLYPH_WIDTH = 5;
+    static const int GLYPH_HEIGHT = 7;
+    static const int ADVANCE = 6;     // Font pixels from one character to the next
+    static const int LINE_HEIGHT = 10;
+    static const int MARGIN = 4;
+
+    unsigned int VAO = 0, VBO = 0, program = 0;
+    GLint screenSizeLoc = -1;
+    std::vector<OverlayVertex> vertices;
+    long long builtAt = 0;
+
+    static const Glyph* glyph(char c) {
+        static const Glyph GLYPHS[] = {
+            { '0', { 0b01110, 0b10001, 0b10011, 0b10101, 0b11001, 0b10001, 0b01110 } },
+            { '1', { 0b00100, 0b01100, 0b00100, 0b00100, 0b00100, 0b00100, 0b01110 } },
+            { '2', { 0b01110, 0b10001, 0b00001, 0b00010, 0b00100, 0b01000, 0b11111 } },
+            { '3', { 0b11111, 0b00010, 0b00100, 0b00010, 0b00001, 0b10001, 0b01110 } },
+            { '4', { 0b00010, 0b00110, 0b01010, 0b10010, 0b11111, 0b00010, 0b00010 } },
+            { '5', { 0b11111, 0b10000, 0b11110, 0b00001, 0b00001, 0b10001, 0b01110 } },
+            { '6', { 0b00110, 0b01000, 0b10000, 0b11110, 0b10001, 0b10001, 0b01110 } },
+            { '7', { 0b11111, 0b00001, 0b00010, 0b00100, 0b01000, 0b01000, 0b01000 } },
+            { '8', { 0b01110, 0b10001, 0b10001, 0b01110, 0b10001, 0b10001, 0b01110 } },
+            { '9', { 0b01110, 0b10001, 0b10001, 0b01111, 0b00001, 0b00010, 0b01100 } },
+            { 'A', { 0b01110, 0b10001, 0b10001, 0b11111, 0b10001, 0b10001, 0b10001 } },
+            { 'B', { 0b11110, 0b10001, 0b10001, 0b11110, 0b10001, 0b10001, 0b11110 } },
+            { 'C', { 0b01110, 0b10001, 0b10000, 0b10000, 0b10000, 0b10001, 0b01110 } },
+            { 'D', { 0b11100, 0b10010, 0b10001, 0b10001, 0b10001, 0b10010, 0b11100 } },
+            { 'E', { 0b11111, 0b10000, 0b10000, 0b11110, 0b10000, 0b10000, 0b11111 } },
+            { 'F', { 0b11111, 0b10000, 0b10000, 0b11110, 0b10000, 0b10000, 0b10000 } },
+            { 'G', { 0b01110, 0b10001, 0b10000, 0b10111, 0b10001, 0b10001, 0b01111 } },
+            { 'H', { 0b10001, 0b10001, 0b10001, 0b11111, 0b10001, 0b10001, 0b10001 } },
+            { 'I', { 0b01110, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100, 0b01110 } },
+            { 'J', { 0b00111, 0b00010, 0b00010, 0b00010, 0b00010, 0b10010, 0b01100 } },
+            { 'K', { 0b10001, 0b10010, 0b10100, 0b11000, 0b10100, 0b10010, 0b10001 } },
+            { 'L', { 0b10000, 0b10000, 0b10000, 0b10000, 0b10000, 0b10000, 0b11111 } },
+            { 'M', { 0b10001, 0b11011, 0b10101, 0b10101, 0b10001, 0b10001, 0b10001 } },
+            { 'N', { 0b10001, 0b10001, 0b11001, 0b10101, 0b10011, 0b10001, 0b10001 } },
+            { 'O', { 0b01110, 0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b01110 } },
+            { 'P', { 0b11110, 0b10001, 0b10001, 0b11110, 0b10000, 0b10000, 0b10000 } },
+            { 'Q', { 0b01110, 0b10001, 0b10001, 0b10001, 0b10101, 0b10010, 0b01101 } },
+            { 'R', { 0b11110, 0b10001, 0b10001, 0b11110, 0b10100, 0b10010, 0b10001 } },
+            { 'S', { 0b01111, 0b10000, 0b10000, 0b01110, 0b00001, 0b00001, 0b11110 } },
+            { 'T', { 0b11111, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100 } },
+            { 'U', { 0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b01110 } },
+            { 'V', { 0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b01010, 0b00100 } },
+            { 'W', { 0b10001, 0b10001, 0b10001, 0b10101, 0b10101, 0b10101, 0b01010 } },
+            { 'X', { 0b10001, 0b10001, 0b01010, 0b00100, 0b01010, 0b10001, 0b10001 } },
+            { 'Y', { 0b10001, 0b10001, 0b10001, 0b01010, 0b00100, 0b00100, 0b00100 } },
+            { 'Z', { 0b11111, 0b00001, 0b00010, 0b00100, 0b01000, 0b10000, 0b11111 } },
+            { '.', { 0b00000, 0b00000, 0b00000, 0b00000, 0b00000, 0b01100, 0b01100 } },
+            { ',', { 0b00000, 0b00000, 0b00000, 0b00000, 0b01100, 0b00100, 0b01000 } },
+            { ':', { 0b00000, 0b01100, 0b01100, 0b00000, 0b01100, 0b01100, 0b00000 } },
+            { '-', { 0b00000, 0b00000, 0b00000, 0b11111, 0b00000, 0b00000, 0b00000 } },
+            { '_', { 0b00000, 0b00000, 0b00000, 0b00000, 0b00000, 0b00000, 0b11111 } },
+            { '/', { 0b00000, 0b00001, 0b00010, 0b00100, 0b01000, 0b10000, 0b00000 } },
+            { '(', { 0b00010, 0b00100, 0b01000, 0b01000, 0b01000, 0b00100, 0b00010 } },
+            { ')', { 0b01000, 0b00100, 0b00010, 0b00010, 0b00010, 0b00100, 0b01000 } },
+            { '%', { 0b11000, 0b11001, 0b00010, 0b00100, 0b01000, 0b10011, 0b00011 } },
+            { '=', { 0b00000, 0b00000, 0b11111, 0b00000, 0b11111, 0b00000, 0b00000 } },
+            { '?', { 0b01110, 0b10001, 0b00001, 0b00010, 0b00100, 0b00000, 0b00100 } },
+        };
+        if (c >= 'a' && c <= 'z') c = (char)(c - 'a' + 'A');
+        for (const Glyph& g : GLYPHS) {
+            if (g.c == c) return &g;
+        }
+        return nullptr; // Space, or not in the font: left blank
+    }
+
+    void init() {
+        const char* vertexSource = R"(
+            #version 460 core
+            layout (location = 0) in vec2 aPos;
+            layout (location = 1) in vec4 aColor;
+            uniform vec2 screenSize;
+            out vec4 color;
+            void main() {
+                gl_Position = vec4(aPos.x / screenSize.x * 2.0 - 1.0, 1.0 - aPos.y / screenSize.y * 2.0, 0.0, 1.0);
+                color = aColor;
+            }
+        )";
+        const char* fragmentSource = R"(
+            #version 460 core
+            in vec4 color;
+            out vec4 FragColor;
+            void main() {
+                FragColor = color;
+            }
+        )";
+        unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(vertexShader, 1, &vertexSource, NULL);
+        glCompileShader(vertexShader);
+        unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(fragmentShader, 1, &fragmentSource, NULL);
+        glCompileShader(fragmentShader);
+        program = glCreateProgram();
+        glAttachShader(program, vertexShader);
+        glAttachShader(program, fragmentShader);
+        glLinkProgram(program);
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        screenSizeLoc = glGetUniformLocation(program, "screenSize");
+
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(OverlayVertex), (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(OverlayVertex), (void*)offsetof(OverlayVertex, r));
+        glEnableVertexAttribArray(1);
+    }
+
+    void addRect(float x0, float y0, float x1, float y1, float r, float g, float b, float a) {
+        vertices.push_back({ x0, y0, r, g, b, a });
+        vertices.push_back({ x1, y0, r, g, b, a });
+        vertices.push_back({ x1, y1, r, g, b, a });
+        vertices.push_back({ x0, y0, r, g, b, a });
+        vertices.push_back({ x1, y1, r, g, b, a });
+        vertices.push_back({ x0, y1, r, g, b, a });
+    }
+
+    // One rect per horizontal run of lit pixels
+    void addText(const std::string& text, int line, float brightness) {
+        float top = (float)(MARGIN + line * LINE_HEIGHT) * PIXEL_SCALE;
+        for (size_t i = 0; i < text.size(); i++) {
+            const Glyph* g = glyph(text[i]);
+            if (!g) continue;
+            float left = (float)(MARGIN + (int)i * ADVANCE) * PIXEL_SCALE;
+            for (int row = 0; row < GLYPH_HEIGHT; row++) {
+                int bits = g->rows[row];
+                int col = 0;
+                while (col < GLYPH_WIDTH) {
+                    if (!(bits & (1 << (GLYPH_WIDTH - 1 - col)))) { col++; continue; }
+                    int runStart = col;
+                    while (col < GLYPH_WIDTH && (bits & (1 << (GLYPH_WIDTH - 1 - col)))) col++;
+                    addRect(left + runStart * PIXEL_SCALE, top + row * PIXEL_SCALE,
+                        left + col * PIXEL_SCALE, top + (row + 1) * PIXEL_SCALE,
+                        brightness, brightness, brightness, 1.0f);
+                }
+            }
+        }
+    }
+
+    // Depth-first, children in the order they were first seen
+    static void appendTree(const std::vector<Profiler::Zone>& zones, int parent, std::vector<int>& order) {
+        for (int i = 0; i < (int)zones.size(); i++) {
+            if (zones[i].parent != parent) continue;
+            order.push_back(i);
+            appendTree(zones, i, order);
+        }
+    }
+
+    void rebuild() {
+        const std::vector<Profiler::Zone>& zones = Profiler::allZones();
+        std::vector<int> order;
+        appendTree(zones, -1, order);
+
+        std::vector<std::string> lines;
+        char line[128];
+        snprintf(line, sizeof(line), "%-*s%8s%8s%8s", NAME_COLUMNS, "ZONE (MS)", "P50", "P99", "MAX");
+        lines.push_back(line);
+        for (int zone : order) {
+            std::string name = std::string(zones[zone].depth * 2, ' ') + zones[zone].name;
+            if (name.size() > (size_t)NAME_COLUMNS - 1) name.resize(NAME_COLUMNS - 1);
+            Profiler::Stats stats = Profiler::stats(zone);
+            snprintf(line, sizeof(line), "%-*s%8.2f%8.2f%8.2f", NAME_COLUMNS, name.c_str(), stats.p50, stats.p99, stats.max);
+            lines.push_back(line);
+        }
+        if (!GpuTimer::supported()) lines.push_back("GPU TIMING NOT SUPPORTED");
+        if (Profiler::isRecording()) {
+            snprintf(line, sizeof(line), "CSV: RECORDING, %zu FRAMES (F4 TO STOP)", Profiler::recordedRows());
+            lines.push_back(line);
+        }
+        else {
+            lines.push_back("F3: HIDE   F4: RECORD CSV");
+        }
+
+        vertices.clear();
+        size_t columns = 0;
+        for (const std::string& text : lines) columns = std::max(columns, text.size());
+        float width = (float)(MARGIN * 2 + (int)columns * ADVANCE) * PIXEL_SCALE;
+        float height = (float)(MARGIN * 2 + (int)lines.size() * LINE_HEIGHT) * PIXEL_SCALE;
+        addRect(0.0f, 0.0f, width, height, 0.0f, 0.0f, 0.0f, 0.6f);
+        for (size_t i = 0; i < lines.size(); i++) {
+            addText(lines[i], (int)i, i == 0 ? 0.7f : 1.0f);
+        }
+    }
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <map>
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+
+// Hands out ranges of a linear space of `size` units (vertices of a big buffer, say).
+// Best fit: the smallest free range that holds the request, so large free ranges stay
+// whole for large requests. A freed range merges with the free ranges on either side.
+// Not thread-safe.
+class RangeAllocator {
+public:
+    static const uint32_t INVALID = UINT32_MAX;
+
+    RangeAllocator() = default;
+
+    explicit RangeAllocator(uint32_t size) {
+        grow(size);
+    }
+
+    // Offset of `count` free units, or INVALID if no free range is big enough
+    uint32_t allocate(uint32_t count) {
+        if (count == 0) return INVALID;
+        auto fit = bySize.lower_bound(count);
+        if (fit == bySize.end()) return INVALID;
+
+        uint32_t offset = fit->second;
+        uint32_t length = fit->first;
+        bySize.erase(fit);
+        byOffset.erase(offset);
+
+        // Keep what's left over
+        if (length > count) {
+            insertFree(offset + count, length - count);
+        }
+        freeUnits -= count;
+        return offset;
+    }
+
+    // Gives back a range returned by allocate(), with the same count
+    void free(uint32_t offset, uint32_t count) {
+        if (count == 0) return;
+        freeUnits += count;
+
+        // Merge with the free range right after...
+        auto next = byOffset.find(offset + count);
+        if (next != byOffset.end()) {
+            count += next->second;
+            eraseFree(next);
+        }
+        // ...and the one right before
+        auto prev = byOffset.lower_bound(offset);
+        if (prev != byOffset.begin()) {
+            --prev;
+            if (prev->first + prev->second == offset) {
+                offset = prev->first;
+                count += prev->second;
+                eraseFree(prev);
+            }
+        }
+        insertFree(offset, count);
+    }
+
+    // Extends the space to newSize units, the new units are free
+    void grow(uint32_t newSize) {
+        if (newSize <= totalUnits) return;
+        uint32_t added = newSize - totalUnits;
+        uint32_t start = totalUnits;
+        totalUnits = newSize;
+        free(start, added);
+    }
+
+    uint32_t size() const { return totalUnits; }
+    uint32_t freeCount() const { return freeUnits; }
+    size_t freeRangeCount() const { return byOffset.size(); }
+
+    // Size of the free range at the end of the space (0 if the last unit is in use)
+    uint32_t freeTail() const {
+        if (byOffset.empty()) return 0;
+        auto last = std::prev(byOffset.end());
+        return last->first + last->second == totalUnits ? last->second : 0;
+    }
+
+private:
+    uint32_t totalUnits = 0;
+    uint32_t freeUnits = 0;
+    std::map<uint32_t, uint32_t> byOffset;    // Free ranges: offset -> length
+    std::multimap<uint32_t, uint32_t> bySize; // The same ranges: length -> offset
+
+    void insertFree(uint32_t offset, uint32_t length) {
+        byOffset[offset] = length;
+        bySize.insert({ length, offset });
+    }
+
+    void eraseFree(std::map<uint32_t, uint32_t>::iterator it) {
+        auto range = bySize.equal_range(it->second);
+        for (auto s = range.first; s != range.second; ++s) {
+            if (s->second == it->first) {
+                bySize.erase(s);
+                break;
+            }
+        }
+        byOffset.erase(it);
+    }
+};
@@ -0,0 +1,256 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+
+// Chunks per region side: one region file holds 32 x 32 chunks
+const int REGION_SIZE = 32;
+const int REGION_CHUNKS = REGION_SIZE * REGION_SIZE;
+const int REGION_SECTOR_SIZE = 512;
+
+// One region file.
+// Layout: a header table with one {uint32 firstSector, uint32 byteLength} entry per
+// chunk (chunk (lx, lz) at index lz * REGION_SIZE + lx, firstSector 0 = not stored),
+// then the chunk data. Every chunk occupies a run of whole 512-byte sectors; a chunk
+// that still fits its run is rewritten in place, otherwise it moves to the first
+// free run big enough (or the end of the file) and its old sectors are reused.
+// All methods are thread-safe.
+class RegionFile {
+public:
+    struct Entry {
+        uint32_t firstSector;
+        uint32_t length;
+    };
+    static const int HEADER_SECTORS = (REGION_CHUNKS * sizeof(Entry) + REGION_SECTOR_SIZE - 1) / REGION_SECTOR_SIZE;
+
+    // Opens the region file, creating it if `create` is set
+    RegionFile(const std::string& path, bool create) {
+        namespace fs = std::filesystem;
+        memset(table, 0, sizeof(table));
+
+        if (!fs::exists(path)) {
+            if (!create) return;
+            // Start with an empty header
+            std::ofstream init(path, std::ios::binary);
+            std::vector<char> header((size_t)HEADER_SECTORS * REGION_SECTOR_SIZE, 0);
+            init.write(header.data(), header.size());
+        }
+
+        file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open region file: " << path << std::endl;
+            return;
+        }
+
+        file.read((char*)table, sizeof(table));
+        if (!file) {
+            std::cerr << "Corrupt region header: " << path << std::endl;
+            file.close();
+            return;
+        }
+
+        // Rebuild the sector usage map from the table. Entries pointing into the header,
+        // past the end of the file or at sectors another entry already uses are corrupt:
+        // drop them (those chunks count as never saved) instead of trusting them, or a
+        // later write would overwrite data still in use.
+        file.seekg(0, std::ios::end);
+        uint64_t fileSize = (uint64_t)file.tellg();
+        usedSectors.assign(HEADER_SECTORS, true);
+        int badEntries = 0;
+        for (Entry& e : table) {
+            if (e.firstSector == 0) continue;
+            bool valid = e.firstSector >= HEADER_SECTORS && (uint64_t)e.firstSector * REGION_SECTOR_SIZE + e.length <= fileSize;
+            for (uint32_t i = 0; valid && i < sectorsFor(e.length); i++) {
+                uint32_t sector = e.firstSector + i;
+                valid = sector >= usedSectors.size() || !usedSectors[sector];
+            }
+            if (!valid) {
+                e = {};
+                badEntries++;
+                continue;
+            }
+            markSectors(e.firstSector, sectorsFor(e.length), true);
+        }
+        if (badEntries > 0) {
+            std::cerr << "Corrupt region header: " << path << " (" << badEntries << " chunk entries dropped)" << std::endl;
+        }
+    }
+
+    bool isOpen() const {
+        return file.is_open();
+    }
+
+    // False if the chunk isn't stored in this region
+    bool read(int lx, int lz, std::vector<uint8_t>& out) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!file.is_open()) return false;
+
+        const Entry& e = table[lz * REGION_SIZE + lx];
+        if (e.firstSector == 0) return false;
+
+        out.resize(e.length);
+        file.clear();
+        file.seekg((std::streamoff)e.firstSector * REGION_SECTOR_SIZE);
+        file.read((char*)out.data(), e.length);
+        return (bool)file;
+    }
+
+    bool write(int lx, int lz, const uint8_t* data, size_t size) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!file.is_open()) return false;
+
+        Entry& e = table[lz * REGION_SIZE + lx];
+        uint32_t needed = sectorsFor((uint32_t)size);
+        uint32_t first = e.firstSector;
+
+        if (first != 0 && needed <= sectorsFor(e.length)) {
+            // Fits where it is: rewrite in place, give back the sectors it no longer needs
+            markSectors(first + needed, sectorsFor(e.length) - needed, false);
+        }
+        else {
+            if (first != 0) {
+                markSectors(first, sectorsFor(e.length), false);
+            }
+            first = findFreeRun(needed);
+            markSectors(first, needed, true);
+        }
+
+        // Data, padded to whole sectors so the file always ends on a sector boundary
+        std::vector<char> padded((size_t)needed * REGION_SECTOR_SIZE, 0);
+        memcpy(padded.data(), data, size);
+        file.clear();
+        file.seekp((std::streamoff)first * REGION_SECTOR_SIZE);
+        file.write(padded.data(), padded.size());
+
+        // Only then point the header at it
+        e.firstSector = first;
+        e.length = (uint32_t)size;
+        file.seekp((std::streamoff)(&e - table) * sizeof(Entry));
+        file.write((const char*)&e, sizeof(Entry));
+        file.flush();
+        return (bool)file;
+    }
+
+private:
+    std::fstream file;
+    Entry table[REGION_CHUNKS];
+    std::vector<bool> usedSectors; // Grows with the file
+    std::mutex mutex;
+
+    static uint32_t sectorsFor(uint32_t length) {
+        return (length + REGION_SECTOR_SIZE - 1) / REGION_SECTOR_SIZE;
+    }
+
+    void markSectors(uint32_t first, uint32_t count, bool used) {
+        if (first + count > usedSectors.size()) {
+            usedSectors.resize(first + count, false);
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            usedSectors[first + i] = used;
+        }
+    }
+
+    // First run of `count` free sectors, or the end of the file
+    uint32_t findFreeRun(uint32_t count) {
+        uint32_t runStart = 0, runLength = 0;
+        for (uint32_t i = HEADER_SECTORS; i < usedSectors.size(); i++) {
+            if (usedSectors[i]) {
+                runLength = 0;
+                continue;
+            }
+            if (runLength == 0) runStart = i;
+            if (++runLength == count) return runStart;
+        }
+        // Extend a free run that reaches the end of the file
+        return runLength > 0 ? runStart : (uint32_t)usedSectors.size();
+    }
+};
+
+// All region files of a world folder, opened on demand and kept open.
+// Takes chunk coordinates; safe to use from several threads.
+class RegionStore {
+public:
+    explicit RegionStore(std::string folder) : folder(std::move(folder)) {
+    }
+
+    // False if the chunk was never saved
+    bool read(int cx, int cz, std::vector<uint8_t>& out) {
+        std::shared_ptr<RegionFile> region = getRegion(regionCoord(cx), regionCoord(cz), false);
+        if (!region) return false;
+        return region->read(cx - regionCoord(cx) * REGION_SIZE, cz - regionCoord(cz) * REGION_SIZE, out);
+    }
+
+    bool write(int cx, int cz, const uint8_t* data, size_t size) {
+        std::shared_ptr<RegionFile> region = getRegion(regionCoord(cx), regionCoord(cz), true);
+        if (!region) return false;
+        return region->write(cx - regionCoord(cx) * REGION_SIZE, cz - regionCoord(cz) * REGION_SIZE, data, size);
+    }
+
+    static int regionCoord(int chunkCoord) {
+        return chunkCoord >= 0 ? chunkCoord / REGION_SIZE : (chunkCoord + 1) / REGION_SIZE - 1;
+    }
+
+    std::string regionFilename(int rx, int rz) const {
+        return folder + "r." + std::to_string(rx) + "." + std::to_string(rz) + ".region";
+    }
+
+private:
+    std::string folder;
+    std::mutex mutex;
+    std::map<std::pair<int, int>, std::shared_ptr<RegionFile>> regions;
+
+    std::shared_ptr<RegionFile> getRegion(int rx, int rz, bool create) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = regions.find({ rx, rz });
+        if (it != regions.end()) return it->second;
+
+        std::shared_ptr<RegionFile> region = std::make_shared<RegionFile>(regionFilename(rx, rz), create);
+        if (!region->isOpen()) return nullptr; // Not created yet (reads) or failed to open
+        regions[{rx, rz}] = region;
+        return region;
+    }
+};
+
+// One-shot migration from the old one-file-per-chunk layout (chunk_X_Z.bin) into
+// region files. Files of the wrong size are left alone, migrated ones are deleted.
+// Returns how many chunks were moved.
+inline int migrateChunkFiles(const std::string& folder, RegionStore& store, size_t chunkSize) {
+    namespace fs = std::filesystem;
+    int migrated = 0;
+    std::vector<fs::path> done;
+
+    for (const fs::directory_entry& entry : fs::directory_iterator(folder)) {
+        if (!entry.is_regular_file()) continue;
+
+        // Exactly chunk_<x>_<z>.bin, not backups like chunk_1_2.bin.bak
+        int cx, cz;
+        int end = -1;
+        std::string name = entry.path().filename().string();
+        if (sscanf(name.c_str(), "chunk_%d_%d.bin%n", &cx, &cz, &end) != 2 || end != (int)name.size()) continue;
+        if (entry.file_size() != chunkSize) continue;
+
+        std::ifstream in(entry.path(), std::ios::binary);
+        std::vector<uint8_t> data(chunkSize);
+        if (!in.read((char*)data.data(), chunkSize)) continue;
+
+        if (store.write(cx, cz, data.data(), data.size())) {
+            done.push_back(entry.path());
+            migrated++;
+        }
+    }
+
+    for (const fs::path& path : done) {
+        std::error_code ignored;
+        fs::remove(path, ignored);
+    }
+    return migrated;
+}
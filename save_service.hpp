@@ -0,0 +1,118 @@
+#pragma once
+
+#include <map>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <condition_variable>
+
+// Writes chunk snapshots to disk on a background I/O thread.
+// A snapshot is an opaque copy of a chunk's block data, taken on the main thread,
+// so the chunk can keep changing (or be unloaded) while it is written. Queuing a
+// chunk that is still waiting replaces the older snapshot, so repeated edits to
+// the same chunk become one write. Pending snapshots are written before the
+// service is destroyed.
+class ChunkSaveService {
+public:
+    using Snapshot = std::vector<uint8_t>;
+    using Writer = std::function<void(int x, int z, const Snapshot& data)>;
+
+    // How long the I/O thread lets edits pile up before writing a batch
+    std::chrono::milliseconds coalesceDelay{ 500 };
+
+    explicit ChunkSaveService(Writer writer) : writer(std::move(writer)) {
+        ioThread = std::thread([this] { ioLoop(); });
+    }
+
+    ~ChunkSaveService() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+        ioThread.join();
+    }
+
+    ChunkSaveService(const ChunkSaveService&) = delete;
+    ChunkSaveService& operator=(const ChunkSaveService&) = delete;
+
+    void queue(int x, int z, Snapshot data) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending[{x, z}] = std::make_shared<const Snapshot>(std::move(data));
+        }
+        wakeUp.notify_all();
+    }
+
+    // The newest snapshot of (x, z) that hasn't reached the disk yet. Loads must check
+    // this first, the file may still hold older data.
+    bool getPending(int x, int z, Snapshot& out) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = pending.find({ x, z });
+        if (it == pending.end()) return false;
+        out = *it->second;
+        return true;
+    }
+
+    // Blocks until everything queued so far is on disk
+    void flush() {
+        std::unique_lock<std::mutex> lock(mutex);
+        flushWaiters++;
+        wakeUp.notify_all();
+        idle.wait(lock, [this] { return pending.empty(); });
+        flushWaiters--;
+    }
+
+    size_t pendingCount() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return pending.size();
+    }
+
+private:
+    Writer writer;
+    std::thread ioThread;
+
+    std::mutex mutex;
+    std::condition_variable wakeUp; // New work, flush request or shutdown
+    std::condition_variable idle;   // Everything written
+    std::map<std::pair<int, int>, std::shared_ptr<const Snapshot>> pending;
+    int flushWaiters = 0;
+    bool stopping = false;
+
+    void ioLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wakeUp.wait(lock, [this] { return stopping || !pending.empty(); });
+            if (pending.empty()) return; // Stopping with nothing left to write
+
+            // Let a burst of edits settle, unless someone is waiting for the data
+            if (!stopping && flushWaiters == 0) {
+                wakeUp.wait_for(lock, coalesceDelay, [this] { return stopping || flushWaiters > 0; });
+            }
+
+            // Write outside the lock. Snapshots stay in `pending` until they are on disk,
+            // so getPending() keeps seeing them while the file is being replaced.
+            std::vector<std::pair<std::pair<int, int>, std::shared_ptr<const Snapshot>>> batch(pending.begin(), pending.end());
+            lock.unlock();
+            for (auto& entry : batch) {
+                writer(entry.first.first, entry.first.second, *entry.second);
+            }
+            lock.lock();
+
+            // Keep entries that were re-queued while we were writing
+            for (auto& entry : batch) {
+                auto it = pending.find(entry.first);
+                if (it != pending.end() && it->second == entry.second) {
+                    pending.erase(it);
+                }
+            }
+            if (pending.empty()) {
+                idle.notify_all();
+            }
+        }
+    }
+};
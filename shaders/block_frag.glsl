@@ -2,13 +2,6 @@
 
 out vec4 FragColor;
 
-struct Light
-{
-    vec3 direction;
-    vec3 ambient;
-    vec3 diffuse;
-};
-
 // We don't really need a struct for Material anymore since 
 // the texture is an array, but we can keep the concept simple:
 uniform sampler2DArray blockTextureArray; // <--- CHANGED: The array of all block images
@@ -17,7 +10,17 @@ in vec3 TexCoord; // (u, v, layer_index)
 in vec3 Normal;  
 in vec3 FragPos;  
 
-uniform Light light;
+// Per-frame values, one uniform buffer shared by every program
+// (FrameUniforms / FRAME_UNIFORMS_BINDING in frame_uniforms.hpp)
+layout (std140, binding = 0) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPos;        // xyz
+    vec4 fog;            // rgb = color, a = density
+    vec4 lightDirection; // xyz
+    vec4 lightAmbient;   // rgb
+    vec4 lightDiffuse;   // rgb
+};
 
 void main()
 {
@@ -25,13 +28,13 @@ void main()
     vec4 texColor = texture(blockTextureArray, TexCoord);
 
     // Ambient
-    vec3 ambient = light.ambient * vec3(texColor);
+    vec3 ambient = lightAmbient.rgb * vec3(texColor);
   
     // Diffuse 
     vec3 norm = normalize(Normal);
-    vec3 lightDir = normalize(-light.direction);
+    vec3 lightDir = normalize(-lightDirection.xyz);
     float diff = max(dot(norm, lightDir), 0.0);
-    vec3 diffuse = light.diffuse * diff * vec3(texColor);  
+    vec3 diffuse = lightDiffuse.rgb * diff * vec3(texColor);  
     
     vec3 result = ambient + diffuse;
     FragColor = vec4(result, 1.0);
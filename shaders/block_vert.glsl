@@ -1,29 +1,56 @@
 #version 460 core
 
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
-layout (location = 2) in vec3 aColor;    // Kept if you use vertex colors, otherwise optional
-layout (location = 3) in vec2 aTexCoord; // Standard UV
-layout (location = 4) in float aTexIndex;// <--- NEW: The Texture ID (0, 1, 2...)
+layout (location = 0) in uvec4 aPosFace; // Local X, Y, Z (0..16) + face index
+layout (location = 1) in uint aLayer;    // The Texture ID (0, 1, 2...)
 
 out vec3 FragPos;
 out vec3 Normal;
-out vec3 TexCoord; // <--- CHANGED: Now a vec3 to hold the index
+out vec3 TexCoord; // (u, v, layer_index)
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+// World position of each drawn section's (0,0,0) corner, one per draw command
+// (SECTION_ORIGINS_BINDING in world_renderer.hpp)
+layout (std430, binding = 0) readonly buffer SectionOrigins {
+    vec4 sectionOrigins[];
+};
+
+// Per-frame values, one uniform buffer shared by every program
+// (FrameUniforms / FRAME_UNIFORMS_BINDING in frame_uniforms.hpp)
+layout (std140, binding = 0) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPos;        // xyz
+    vec4 fog;            // rgb = color, a = density
+    vec4 lightDirection; // xyz
+    vec4 lightAmbient;   // rgb
+    vec4 lightDiffuse;   // rgb
+};
+
+// Same order as BlockFace in chunk.hpp
+const vec3 FACE_NORMALS[6] = vec3[6](
+    vec3(0.0, 1.0, 0.0), vec3(0.0, -1.0, 0.0),
+    vec3(0.0, 0.0, 1.0), vec3(0.0, 0.0, -1.0),
+    vec3(-1.0, 0.0, 0.0), vec3(1.0, 0.0, 0.0)
+);
 
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0));
+    vec3 localPos = vec3(aPosFace.xyz);
+    uint face = aPosFace.w;
+
+    FragPos = sectionOrigins[gl_DrawID].xyz + localPos;
     
-    // Normal matrix calculation (expensive, but fine for now)
-    mat3 normalMatrix = transpose(inverse(mat3(model)));
-    Normal = normalMatrix * aNormal;
+    // Normals are axis aligned, no normal matrix needed
+    Normal = FACE_NORMALS[face];
 
     gl_Position = projection * view * vec4(FragPos, 1.0);
     
+    // UVs follow the block grid so merged quads repeat the texture once per block
+    vec2 uv;
+    if (face < 2u)       uv = localPos.xz;
+    else if (face < 4u)  uv = vec2(localPos.x, -localPos.y);
+    else if (face == 4u) uv = vec2(-localPos.z, -localPos.y);
+    else                 uv = vec2(localPos.z, -localPos.y);
+
     // Combine the 2D UV and the Index into one 3D coordinate
-    TexCoord = vec3(aTexCoord, aTexIndex); 
+    TexCoord = vec3(uv, float(aLayer)); 
 }
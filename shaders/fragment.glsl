@@ -7,17 +7,17 @@ in vec3 FragPos;
 in float LayerIndex;
 uniform sampler2DArray textureArray;
 
-struct Light {
-    vec3 direction;
-    vec3 ambient;
-    vec3 diffuse;
+// Per-frame values, one uniform buffer shared by every program
+// (FrameUniforms / FRAME_UNIFORMS_BINDING in frame_uniforms.hpp)
+layout (std140, binding = 0) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPos;        // xyz
+    vec4 fog;            // rgb = color, a = density
+    vec4 lightDirection; // xyz
+    vec4 lightAmbient;   // rgb
+    vec4 lightDiffuse;   // rgb
 };
-uniform Light light;
-
-// Fog Uniforms
-uniform vec3 viewPos;
-uniform vec3 fogColor;
-uniform float fogDensity;
 
 void main()
 {
@@ -25,24 +25,25 @@ void main()
     vec4 texColor = texture(textureArray, vec3(TexCoord, LayerIndex));
     
     // Lighting
-    vec3 ambient = light.ambient * texColor.rgb;
+    vec3 ambient = lightAmbient.rgb * texColor.rgb;
     vec3 norm = normalize(Normal);
-    vec3 lightDir = normalize(-light.direction);
+    vec3 lightDir = normalize(-lightDirection.xyz);
     float diff = max(dot(norm, lightDir), 0.0);
-    vec3 diffuse = light.diffuse * diff * texColor.rgb;
+    vec3 diffuse = lightDiffuse.rgb * diff * texColor.rgb;
     vec3 result = ambient + diffuse;
 
     // --- EXPONENTIAL SQUARED FOG ---
-    float distance = length(viewPos - FragPos);
+    float distance = length(viewPos.xyz - FragPos);
     
     // The "Squared" part (dist * dist) makes it much smoother
+    float fogDensity = fog.a;
     float fogFactor = 1.0 - exp(-(distance * fogDensity) * (distance * fogDensity));
     
     // Clamp to 0-1
     fogFactor = clamp(fogFactor, 0.0, 1.0);
 
     // Mix
-    vec3 finalColor = mix(result, fogColor, fogFactor);
+    vec3 finalColor = mix(result, fog.rgb, fogFactor);
 
     FragColor = vec4(finalColor, 1.0);
 }
\ No newline at end of file
@@ -1,25 +1,52 @@
 #version 460 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
-layout (location = 2) in vec3 aColor; 
-layout (location = 3) in vec3 aTexCoord; // Contains: U, V, Layer
+layout (location = 0) in uvec4 aPosFace; // Local X, Y, Z (0..16) + face index
+layout (location = 1) in uint aLayer;    // Texture array layer
 
 out vec2 TexCoord;
 out vec3 Normal;
 out vec3 FragPos;
 out float LayerIndex; // <--- Pass this to Fragment Shader
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+// World position of each drawn section's (0,0,0) corner, one per draw command
+// (SECTION_ORIGINS_BINDING in world_renderer.hpp)
+layout (std430, binding = 0) readonly buffer SectionOrigins {
+    vec4 sectionOrigins[];
+};
+
+// Per-frame values, one uniform buffer shared by every program
+// (FrameUniforms / FRAME_UNIFORMS_BINDING in frame_uniforms.hpp)
+layout (std140, binding = 0) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPos;        // xyz
+    vec4 fog;            // rgb = color, a = density
+    vec4 lightDirection; // xyz
+    vec4 lightAmbient;   // rgb
+    vec4 lightDiffuse;   // rgb
+};
+
+// Same order as BlockFace in chunk.hpp
+const vec3 FACE_NORMALS[6] = vec3[6](
+    vec3(0.0, 1.0, 0.0), vec3(0.0, -1.0, 0.0),
+    vec3(0.0, 0.0, 1.0), vec3(0.0, 0.0, -1.0),
+    vec3(-1.0, 0.0, 0.0), vec3(1.0, 0.0, 0.0)
+);
 
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;  
-    
-    TexCoord = aTexCoord.xy;
-    LayerIndex = aTexCoord.z; // Extract the layer ID
+    vec3 localPos = vec3(aPosFace.xyz);
+    uint face = aPosFace.w;
+
+    FragPos = sectionOrigins[gl_DrawID].xyz + localPos;
+    Normal = FACE_NORMALS[face];
+
+    // UVs follow the block grid so merged quads repeat the texture once per block
+    if (face < 2u)       TexCoord = localPos.xz;                   // Top / Bottom
+    else if (face < 4u)  TexCoord = vec2(localPos.x, -localPos.y); // Front / Back
+    else if (face == 4u) TexCoord = vec2(-localPos.z, -localPos.y); // Left
+    else                 TexCoord = vec2(localPos.z, -localPos.y);  // Right
+
+    LayerIndex = float(aLayer); // Extract the layer ID
     
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
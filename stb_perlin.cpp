@@ -0,0 +1,4 @@
+// stb_perlin's implementation, used by TerrainNoise (terrain_noise.hpp). In a file of
+// its own so the headless core library has it without main.cpp.
+#define STB_PERLIN_IMPLEMENTATION
+#include "stb_perlin.h"
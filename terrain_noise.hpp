@@ -0,0 +1,193 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// From stb_perlin.h, whose implementation is compiled in stb_perlin.cpp
+extern float stb_perlin_noise3(float x, float y, float z, int x_wrap, int y_wrap, int z_wrap);
+
+#if defined(__AVX2__)
+#define TERRAIN_NOISE_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TERRAIN_NOISE_SSE2
+#include <emmintrin.h>
+#endif
+
+// 2D gradient noise, batched and vectorized, giving the same values as
+// stb_perlin_noise3(x, y, 0, 0, 0, 0) (up to float rounding).
+//
+// With z = 0 and no wrapping, stb's noise only depends on the X/Y components of the
+// gradient at each corner of the 256 x 256 lattice, and those are always -1, 0 or 1.
+// stb keeps its tables private, so they are read back through stb_perlin_noise3 itself
+// once: a tiny step away from a lattice point along X (or Y) returns the gradient's X
+// (or Y) component times the step. After that a sample is 4 table lookups and some
+// arithmetic, done 8 lanes at a time with AVX2, 4 with SSE2, or one by one otherwise.
+struct TerrainNoise {
+    // out[i] = noise at (xs[i], ys[i])
+    static void noise2(const float* xs, const float* ys, float* out, int count) {
+        const uint8_t* table = gradients();
+        int i = 0;
+#if defined(TERRAIN_NOISE_AVX2)
+        for (; i + 8 <= count; i += 8) {
+            noise2x8(table, xs + i, ys + i, out + i);
+        }
+#elif defined(TERRAIN_NOISE_SSE2)
+        for (; i + 4 <= count; i += 4) {
+            noise2x4(table, xs + i, ys + i, out + i);
+        }
+#endif
+        for (; i < count; i++) {
+            out[i] = noise2(table, xs[i], ys[i]);
+        }
+    }
+
+    static float noise2(float x, float y) {
+        return noise2(gradients(), x, y);
+    }
+
+private:
+    // Gradient at lattice point (ix, iy), index (ix << 8) | iy: bits 0-1 hold X + 1,
+    // bits 2-3 hold Y + 1. 3 bytes of padding so AVX2 can gather 32 bits at the last entry.
+    static const uint8_t* gradients() {
+        static const std::vector<uint8_t> table = [] {
+            std::vector<uint8_t> t(256 * 256 + 3, 0);
+            // Exact in float, and small enough that the neighbouring corners weigh
+            // in at under 0.01% (the ease curve is ~10 step^3 there)
+            const float step = 1.0f / 64.0f;
+            for (int ix = 0; ix < 256; ix++) {
+                for (int iy = 0; iy < 256; iy++) {
+                    int gx = (int)lroundf(stb_perlin_noise3(ix + step, (float)iy, 0, 0, 0, 0) / step);
+                    int gy = (int)lroundf(stb_perlin_noise3((float)ix, iy + step, 0, 0, 0, 0) / step);
+                    t[(ix << 8) | iy] = (uint8_t)((gx + 1) | ((gy + 1) << 2));
+                }
+            }
+            return t;
+        }();
+        return table.data();
+    }
+
+    // stb's fade curve
+    static float ease(float a) {
+        return ((a * 6 - 15) * a + 10) * a * a * a;
+    }
+
+    static float lerp(float a, float b, float t) {
+        return a + (b - a) * t;
+    }
+
+    static float corner(const uint8_t* table, int ix, int iy, float dx, float dy) {
+        uint8_t g = table[((ix & 255) << 8) | (iy & 255)];
+        return (float)((g & 3) - 1) * dx + (float)(((g >> 2) & 3) - 1) * dy;
+    }
+
+    static float noise2(const uint8_t* table, float x, float y) {
+        float floorX = floorf(x), floorY = floorf(y);
+        int px = (int)floorX, py = (int)floorY;
+        float fx = x - floorX, fy = y - floorY;
+
+        float n00 = corner(table, px, py, fx, fy);
+        float n01 = corner(table, px, py + 1, fx, fy - 1);
+        float n10 = corner(table, px + 1, py, fx - 1, fy);
+        float n11 = corner(table, px + 1, py + 1, fx - 1, fy - 1);
+
+        float v = ease(fy);
+        return lerp(lerp(n00, n01, v), lerp(n10, n11, v), ease(fx));
+    }
+
+#if defined(TERRAIN_NOISE_AVX2)
+    static __m256 ease(__m256 a) {
+        __m256 r = _mm256_sub_ps(_mm256_mul_ps(a, _mm256_set1_ps(6.0f)), _mm256_set1_ps(15.0f));
+        r = _mm256_add_ps(_mm256_mul_ps(r, a), _mm256_set1_ps(10.0f));
+        return _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(r, a), a), a);
+    }
+
+    static __m256 lerp(__m256 a, __m256 b, __m256 t) {
+        return _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), t));
+    }
+
+    static __m256 corner(const uint8_t* table, __m256i index, __m256 dx, __m256 dy) {
+        __m256i g = _mm256_and_si256(_mm256_i32gather_epi32((const int*)table, index, 1), _mm256_set1_epi32(0xFF));
+        __m256i one = _mm256_set1_epi32(1), three = _mm256_set1_epi32(3);
+        __m256 gx = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_and_si256(g, three), one));
+        __m256 gy = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_and_si256(_mm256_srli_epi32(g, 2), three), one));
+        return _mm256_add_ps(_mm256_mul_ps(gx, dx), _mm256_mul_ps(gy, dy));
+    }
+
+    static void noise2x8(const uint8_t* table, const float* xs, const float* ys, float* out) {
+        __m256 x = _mm256_loadu_ps(xs), y = _mm256_loadu_ps(ys);
+        __m256 floorX = _mm256_floor_ps(x), floorY = _mm256_floor_ps(y);
+        __m256 fx = _mm256_sub_ps(x, floorX), fy = _mm256_sub_ps(y, floorY);
+        __m256 fx1 = _mm256_sub_ps(fx, _mm256_set1_ps(1.0f)), fy1 = _mm256_sub_ps(fy, _mm256_set1_ps(1.0f));
+
+        __m256i mask = _mm256_set1_epi32(255), one = _mm256_set1_epi32(1);
+        __m256i px = _mm256_cvttps_epi32(floorX), py = _mm256_cvttps_epi32(floorY);
+        __m256i x0 = _mm256_slli_epi32(_mm256_and_si256(px, mask), 8);
+        __m256i x1 = _mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(px, one), mask), 8);
+        __m256i y0 = _mm256_and_si256(py, mask);
+        __m256i y1 = _mm256_and_si256(_mm256_add_epi32(py, one), mask);
+
+        __m256 n00 = corner(table, _mm256_or_si256(x0, y0), fx, fy);
+        __m256 n01 = corner(table, _mm256_or_si256(x0, y1), fx, fy1);
+        __m256 n10 = corner(table, _mm256_or_si256(x1, y0), fx1, fy);
+        __m256 n11 = corner(table, _mm256_or_si256(x1, y1), fx1, fy1);
+
+        __m256 v = ease(fy);
+        _mm256_storeu_ps(out, lerp(lerp(n00, n01, v), lerp(n10, n11, v), ease(fx)));
+    }
+#elif defined(TERRAIN_NOISE_SSE2)
+    static __m128 ease(__m128 a) {
+        __m128 r = _mm_sub_ps(_mm_mul_ps(a, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f));
+        r = _mm_add_ps(_mm_mul_ps(r, a), _mm_set1_ps(10.0f));
+        return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(r, a), a), a);
+    }
+
+    static __m128 lerp(__m128 a, __m128 b, __m128 t) {
+        return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t));
+    }
+
+    // No gather in SSE2: look the 4 gradients up one by one
+    static __m128 corner(const uint8_t* table, __m128i index, __m128 dx, __m128 dy) {
+        alignas(16) int lanes[4];
+        _mm_store_si128((__m128i*)lanes, index);
+        __m128i g = _mm_setr_epi32(table[lanes[0]], table[lanes[1]], table[lanes[2]], table[lanes[3]]);
+        __m128i one = _mm_set1_epi32(1), three = _mm_set1_epi32(3);
+        __m128 gx = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_and_si128(g, three), one));
+        __m128 gy = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(g, 2), three), one));
+        return _mm_add_ps(_mm_mul_ps(gx, dx), _mm_mul_ps(gy, dy));
+    }
+
+    // floor() without SSE4.1: truncate, then step down where that rounded up
+    static __m128i floorToInt(__m128 a, __m128& floored) {
+        __m128i t = _mm_cvttps_epi32(a);
+        __m128 tf = _mm_cvtepi32_ps(t);
+        __m128i roundedUp = _mm_castps_si128(_mm_cmpgt_ps(tf, a)); // All ones = -1
+        t = _mm_add_epi32(t, roundedUp);
+        floored = _mm_cvtepi32_ps(t);
+        return t;
+    }
+
+    static void noise2x4(const uint8_t* table, const float* xs, const float* ys, float* out) {
+        __m128 x = _mm_loadu_ps(xs), y = _mm_loadu_ps(ys);
+        __m128 floorX, floorY;
+        __m128i px = floorToInt(x, floorX), py = floorToInt(y, floorY);
+        __m128 fx = _mm_sub_ps(x, floorX), fy = _mm_sub_ps(y, floorY);
+        __m128 fx1 = _mm_sub_ps(fx, _mm_set1_ps(1.0f)), fy1 = _mm_sub_ps(fy, _mm_set1_ps(1.0f));
+
+        __m128i mask = _mm_set1_epi32(255), one = _mm_set1_epi32(1);
+        __m128i x0 = _mm_slli_epi32(_mm_and_si128(px, mask), 8);
+        __m128i x1 = _mm_slli_epi32(_mm_and_si128(_mm_add_epi32(px, one), mask), 8);
+        __m128i y0 = _mm_and_si128(py, mask);
+        __m128i y1 = _mm_and_si128(_mm_add_epi32(py, one), mask);
+
+        __m128 n00 = corner(table, _mm_or_si128(x0, y0), fx, fy);
+        __m128 n01 = corner(table, _mm_or_si128(x0, y1), fx, fy1);
+        __m128 n10 = corner(table, _mm_or_si128(x1, y0), fx1, fy);
+        __m128 n11 = corner(table, _mm_or_si128(x1, y1), fx1, fy1);
+
+        __m128 v = ease(fy);
+        _mm_storeu_ps(out, lerp(lerp(n00, n01, v), lerp(n10, n11, v), ease(fx)));
+    }
+#endif
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// Fixed set of worker threads pulling jobs from a shared FIFO queue.
+// Jobs still queued when the pool is destroyed are dropped, running ones finish first.
+class ThreadPool {
+public:
+    // threadCount 0 = one thread per core, minus one for the render thread
+    explicit ThreadPool(unsigned int threadCount = 0) {
+        if (threadCount == 0) {
+            unsigned int cores = std::thread::hardware_concurrency();
+            threadCount = cores > 1 ? cores - 1 : 1;
+        }
+        for (unsigned int i = 0; i < threadCount; i++) {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        stop();
+    }
+
+    // Drops the queued jobs and waits for the running ones. No job runs after this
+    // returns; later submits are dropped too.
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            queue.clear();
+        }
+        wakeUp.notify_all();
+        for (std::thread& t : workers) {
+            if (t.joinable()) t.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopping) return;
+            queue.push_back(std::move(job));
+        }
+        wakeUp.notify_one();
+    }
+
+    // Jobs waiting for a worker (not counting the ones running)
+    size_t queuedJobs() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return queue.size();
+    }
+
+    unsigned int threadCount() const {
+        return (unsigned int)workers.size();
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> queue;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    bool stopping = false;
+
+    void workerLoop() {
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeUp.wait(lock, [this] { return stopping || !queue.empty(); });
+                if (stopping) return;
+
+                job = std::move(queue.front());
+                queue.pop_front();
+            }
+            job();
+        }
+    }
+};
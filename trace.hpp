@@ -0,0 +1,191 @@
+#pragma once
+
+#include <map>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+
+// Chunk pipeline tracing, written as Chrome trace-event JSON (open it in Perfetto or
+// chrome://tracing). Off by default; between start() and stop() every traced stage of
+// every chunk is kept in memory, stop() writes the file.
+//
+// Stages done in one go (load, generate, mesh, upload, save...) are complete events
+// on the thread that ran them. Waits that span threads and frames ("requested": from
+// the request to the chunk being taken in; "resident": from then on until unload) are
+// async events with one track per chunk. All events carry the chunk's x/z, and the
+// section where it applies.
+class Trace {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Recording stops (with a warning) past this many events, ~50 bytes each
+    static const size_t MAX_EVENTS = 4 << 20;
+
+    static bool isEnabled() {
+        return enabled.load();
+    }
+
+    // Starts a new trace. The calling thread is named "main".
+    static void start() {
+        std::lock_guard<std::mutex> lock(mutex);
+        events.clear();
+        epoch = Clock::now();
+        full = false;
+        threadNames[threadId()] = "main";
+        enabled = true;
+    }
+
+    static bool stop(const std::string& path) {
+        enabled = false;
+        std::lock_guard<std::mutex> lock(mutex);
+        std::ofstream file(path);
+        if (!file) {
+            std::cout << "Trace: can't write " << path << std::endl;
+            events.clear();
+            return false;
+        }
+
+        char line[256];
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool first = true;
+        for (auto& [tid, name] : threadNames) {
+            snprintf(line, sizeof(line), "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                first ? "" : ",\n", tid, name.c_str());
+            file << line;
+            first = false;
+        }
+        for (const Event& e : events) {
+            int n = snprintf(line, sizeof(line), "%s{\"name\":\"%s\",\"cat\":\"chunk\",\"ph\":\"%c\",\"pid\":1,\"tid\":%d,\"ts\":%lld",
+                first ? "" : ",\n", e.name, e.phase, e.tid, (long long)e.start);
+            if (e.phase == 'X') n += snprintf(line + n, sizeof(line) - n, ",\"dur\":%lld", (long long)e.duration);
+            if (e.phase == 'b' || e.phase == 'e') n += snprintf(line + n, sizeof(line) - n, ",\"id\":\"%d,%d\"", e.x, e.z);
+            if (e.phase == 'i') n += snprintf(line + n, sizeof(line) - n, ",\"s\":\"t\"");
+            if (e.section >= 0) snprintf(line + n, sizeof(line) - n, ",\"args\":{\"x\":%d,\"z\":%d,\"section\":%d}}", e.x, e.z, e.section);
+            else snprintf(line + n, sizeof(line) - n, ",\"args\":{\"x\":%d,\"z\":%d}}", e.x, e.z);
+            file << line;
+            first = false;
+        }
+        file << "\n]}\n";
+        std::cout << "Trace: wrote " << events.size() << " events to " << path << std::endl;
+        events.clear();
+        return true;
+    }
+
+    // Names the calling thread in the trace (worker, save I/O...). Cheap to call per job.
+    static void nameThread(const char* name) {
+        if (!isEnabled()) return;
+        thread_local const char* named = nullptr;
+        if (named == name) return;
+        named = name;
+        std::lock_guard<std::mutex> lock(mutex);
+        threadNames[threadId()] = name;
+    }
+
+    // A stage that ran from `start` until now on this thread. `name` must be a literal.
+    static void complete(const char* name, Clock::time_point start, int x, int z, int section = -1) {
+        if (!isEnabled()) return;
+        long long end = micros(Clock::now());
+        long long begin = micros(start);
+        add({ name, 'X', threadId(), x, z, section, begin, end - begin });
+    }
+
+    // Something that happened just now ("first drawn")
+    static void instant(const char* name, int x, int z, int section = -1) {
+        if (!isEnabled()) return;
+        add({ name, 'i', threadId(), x, z, section, micros(Clock::now()), 0 });
+    }
+
+    // A wait on the chunk's own track, may end on another thread
+    static void asyncBegin(const char* name, int x, int z) {
+        if (!isEnabled()) return;
+        add({ name, 'b', threadId(), x, z, -1, micros(Clock::now()), 0 });
+    }
+
+    static void asyncEnd(const char* name, int x, int z) {
+        if (!isEnabled()) return;
+        add({ name, 'e', threadId(), x, z, -1, micros(Clock::now()), 0 });
+    }
+
+private:
+    struct Event {
+        const char* name;
+        char phase; // X complete, i instant, b/e async begin/end
+        int tid;
+        int x, z;
+        int section;
+        long long start;    // Microseconds since start()
+        long long duration;
+    };
+
+    static inline std::atomic<bool> enabled{ false };
+    static inline std::mutex mutex;
+    static inline std::vector<Event> events;
+    static inline std::map<int, std::string> threadNames;
+    static inline Clock::time_point epoch;
+    static inline bool full = false;
+    static inline std::atomic<int> nextThreadId{ 1 };
+
+    static int threadId() {
+        thread_local int id = nextThreadId++;
+        return id;
+    }
+
+    static long long micros(Clock::time_point t) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(t - epoch).count();
+    }
+
+    static void add(const Event& event) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!enabled) return; // Stopped while this event was on its way
+        if (events.size() >= MAX_EVENTS) {
+            if (!full) std::cout << "Trace: event limit reached, later events are dropped" << std::endl;
+            full = true;
+            return;
+        }
+        events.push_back(event);
+    }
+};
+
+// Traces its scope as one stage of a chunk (or of one of its sections). next() ends
+// it and starts the following stage, like ProfileZone::next().
+class TraceSpan {
+public:
+    TraceSpan(const char* name, int x, int z, int section = -1) : x(x), z(z), section(section) {
+        begin(name);
+    }
+
+    ~TraceSpan() {
+        end();
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    void next(const char* nextName) {
+        end();
+        begin(nextName);
+    }
+
+    void end() {
+        if (!name) return;
+        Trace::complete(name, start, x, z, section);
+        name = nullptr;
+    }
+
+private:
+    const char* name = nullptr;
+    int x, z, section;
+    Trace::Clock::time_point start;
+
+    void begin(const char* stageName) {
+        if (!Trace::isEnabled()) return;
+        name = stageName;
+        start = Trace::Clock::now();
+    }
+};
@@ -1,7 +1,16 @@
 #pragma once
 
-#include <map>
+#include <set>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <queue>
+#include <tuple>
+#include <algorithm>
+#include <functional>
 #include <string>
+#include <cstring>
 #include <fstream>
 #include <filesystem>
 #include <iostream>
@@ -9,6 +18,14 @@
 #include <glm/glm.hpp> 
 
 #include "chunk.hpp"
+#include "thread_pool.hpp"
+#include "chunk_map.hpp"
+#include "frustum.hpp"
+#include "save_service.hpp"
+#include "region_file.hpp"
+#include "chunk_codec.hpp"
+#include "profiler.hpp"
+#include "trace.hpp"
 
 namespace fs = std::filesystem;
 
@@ -17,6 +34,10 @@ public:
     // === Settings ===
     bool isInfinite = true;
     int renderDistance = 16;
+    // Sections more than this many sections above/below the player's aren't meshed. The
+    // default covers the whole column wherever the player is (flying high above the
+    // terrain included); lower it to trade distant layers for fewer meshes.
+    int verticalRenderDistance = CHUNK_SECTIONS - 1;
 
     // Boundaries (Used if isInfinite is false)
     const int WORLD_MIN_X = -4;
@@ -24,62 +45,344 @@ public:
     const int WORLD_MIN_Z = -4;
     const int WORLD_MAX_Z = 4;
 
+    // === Streaming budgets ===
+    // Per frame: new load/generate jobs, new mesh jobs and finished meshes uploaded.
+    // Whatever doesn't fit waits for the next frames, most urgent first.
+    int maxChunkRequestsPerFrame = 8;
+    int maxMeshRequestsPerFrame = 16;
+    int maxMeshUploadsPerFrame = 32;
+    // Chunk loads/generations queued on the workers at once. Keeps the queue short so
+    // requests don't go stale while the player moves.
+    int maxChunkRequestsInFlight = 64;
+
+    // How much being in front of the camera / along the movement direction pulls a
+    // chunk forward in the queues (0 = distance only, 1 = ahead is always first)
+    float viewPriorityWeight = 0.4f;
+    float velocityPriorityWeight = 0.4f;
+
+    // === Rendering ===
+    bool frustumCulling = true;
+
+    // Receives every section mesh the world builds. The default keeps only the vertex
+    // counts (no GPU needed); the game swaps in ArenaMeshUploader (world_renderer.hpp).
+    // Set it before the first update().
+    std::unique_ptr<MeshUploader> meshUploader = std::make_unique<MeshUploader>();
+
+    // Section counts of the last forEachVisibleSection() call. Sections with an empty
+    // mesh aren't tested.
+    struct RenderStats {
+        int tested = 0;
+        int culled = 0;
+        int drawn = 0;
+    };
+    RenderStats renderStats;
+
     // === Storage ===
-    std::map<std::pair<int, int>, Chunk*> activeChunks;
-    std::string saveFolder = "saves/world1/";
+    ChunkMap<Chunk*> activeChunks;
+    const std::string saveFolder; // Set by the constructor, the region files are opened in it
+
+    // Chunk coordinate of a world block coordinate (floor division, no float round trip)
+    static int toChunkCoord(int v) {
+        return v >= 0 ? v / CHUNK_SIZE : (v + 1) / CHUNK_SIZE - 1;
+    }
 
     // Get a block ID at global world coordinates
     BlockID getBlock(int x, int y, int z) {
         // 1. Calculate Chunk Coordinate
-        int cx = static_cast<int>(floor(x / (float)CHUNK_SIZE));
-        int cz = static_cast<int>(floor(z / (float)CHUNK_SIZE));
+        int cx = toChunkCoord(x);
+        int cz = toChunkCoord(z);
 
         // 2. Calculate Local Block Coordinate
         int lx = x - (cx * CHUNK_SIZE);
         int lz = z - (cz * CHUNK_SIZE);
 
         // 3. Find Chunk
-        if (activeChunks.find({ cx, cz }) != activeChunks.end()) {
-            Chunk* c = activeChunks[{cx, cz}];
-            // 4. Check Bounds (Y is local to chunk height)
-            if (y >= 0 && y < CHUNK_SIZE && lx >= 0 && lz >= 0) {
-                return c->blocks[y][lx][lz];
+        if (Chunk* c = findChunk(cx, cz)) {
+            // 4. Check Bounds (Y covers the whole column)
+            if (y >= 0 && y < WORLD_HEIGHT && lx >= 0 && lz >= 0) {
+                return c->getBlock(lx, y, lz);
             }
         }
         return BLOCK_AIR;
     }
 
-    World() {
+    explicit World(std::string folder = "saves/world1/") : saveFolder(std::move(folder)) {
         // Ensure save folder exists
         if (!fs::exists(saveFolder)) {
             fs::create_directories(saveFolder);
         }
+
+        // Worlds saved before region files still have one file per chunk
+        int migrated = migrateChunkFiles(saveFolder, regions, BlockStorage::VOLUME);
+        if (migrated > 0) {
+            std::cout << "Migrated " << migrated << " chunk files to region files" << std::endl;
+        }
+    }
+
+    // Saves what's modified, stops the workers, then frees every chunk and its meshes
+    ~World() {
+        shutdown();
+        workers.stop();
+
+        for (auto& slot : activeChunks) {
+            slot.value->del(*meshUploader);
+            delete slot.value;
+        }
+        activeChunks.clear();
+        for (Chunk* c : readyChunks) {
+            c->del(*meshUploader);
+            delete c;
+        }
+        readyChunks.clear();
     }
 
     void setBlock(int x, int y, int z, BlockID type) {
-        int cx = static_cast<int>(floor(x / (float)CHUNK_SIZE));
-        int cz = static_cast<int>(floor(z / (float)CHUNK_SIZE));
+        int cx = toChunkCoord(x);
+        int cz = toChunkCoord(z);
         int lx = x - (cx * CHUNK_SIZE);
         int lz = z - (cz * CHUNK_SIZE);
 
-        if (activeChunks.find({ cx, cz }) != activeChunks.end()) {
-            activeChunks[{cx, cz}]->setBlock(lx, y, lz, type);
+        if (Chunk* c = findChunk(cx, cz)) {
+            if (y < 0 || y >= WORLD_HEIGHT) return;
+
+            int section = y / CHUNK_SIZE;
+            int ly = y % CHUNK_SIZE;
+
+            c->setBlock(lx, y, lz, type);
+
+            // Saved at the end of the frame, so several edits make one snapshot
+            editedChunks.insert({ cx, cz });
+
+            // Remeshed at the end of the frame too, so a bulk edit costs one remesh per
+            // section instead of one per block
+            dirtySections.insert({ cx, section, cz });
+
+            // Blocks on a section boundary are also seen by the section above/below
+            if (ly == 0 && section > 0) dirtySections.insert({ cx, section - 1, cz });
+            if (ly == CHUNK_SIZE - 1 && section + 1 < CHUNK_SECTIONS) dirtySections.insert({ cx, section + 1, cz });
+
+            // Blocks on the edge are also part of the neighbour's border
+            if (lx == 0) dirtySections.insert({ cx - 1, section, cz });
+            if (lx == CHUNK_SIZE - 1) dirtySections.insert({ cx + 1, section, cz });
+            if (lz == 0) dirtySections.insert({ cx, section, cz - 1 });
+            if (lz == CHUNK_SIZE - 1) dirtySections.insert({ cx, section, cz + 1 });
+        }
+    }
+
+    // The loaded chunk at chunk coordinates (cx, cz), or nullptr
+    Chunk* findChunk(int cx, int cz) {
+        Chunk** c = activeChunks.find(cx, cz);
+        return c ? *c : nullptr;
+    }
+
+    // Copies the edges of one section of the loaded neighbours of chunk (cx, cz)
+    ChunkBorders gatherBorders(int cx, int section, int cz) {
+        ChunkBorders borders;
+        for (int side = 0; side < 4; side++) {
+            Chunk* neighbour = findChunk(cx + SIDE_OFFSETS[side][0], cz + SIDE_OFFSETS[side][1]);
+            if (neighbour) {
+                borders.loaded[side] = true;
+                // Our -X side is the neighbour's +X edge, and so on
+                neighbour->copyEdge(side ^ 1, section, borders.edge[side]);
+            }
+        }
+        return borders;
+    }
+
+    // True if a section can't show a single face, so the mesher can skip it: all air,
+    // or all solid with solid sections on every side. Only those sections' edges
+    // matter, but edits to an edge remesh this section anyway.
+    bool isHiddenSection(Chunk* c, int section) {
+        if (c->isEmptySection(section)) return true;
+        if (!c->isSolidSection(section)) return false;
+
+        // The top of the world is open, the bottom is never seen
+        if (section + 1 >= CHUNK_SECTIONS || !c->isSolidSection(section + 1)) return false;
+        if (section > 0 && !c->isSolidSection(section - 1)) return false;
+
+        for (int side = 0; side < 4; side++) {
+            Chunk* neighbour = findChunk(c->x + SIDE_OFFSETS[side][0], c->z + SIDE_OFFSETS[side][1]);
+            if (!neighbour || !neighbour->isSolidSection(section)) return false;
+        }
+        return true;
+    }
+
+    // Synchronous remesh of every section edited since the last call, once each. The
+    // new meshes go through MeshUploader::patch, which can update them in place.
+    void remeshDirtySections() {
+        for (auto [cx, section, cz] : dirtySections) {
+            Chunk* c = findChunk(cx, cz);
+            if (!c) continue; // Neighbour that isn't loaded
+
+            if (!isSectionInRange(section) || isHiddenSection(c, section)) {
+                c->clearMesh(section, *meshUploader);
+                continue;
+            }
+            TraceSpan span("remesh", cx, cz, section);
+            c->regenerateMesh(section, gatherBorders(cx, section, cz), *meshUploader);
+        }
+        dirtySections.clear();
+    }
+
+    // Synchronous remesh of one section
+    void remeshSection(Chunk* c, int section) {
+        if (!isSectionInRange(section) || isHiddenSection(c, section)) {
+            c->clearMesh(section, *meshUploader);
+            return;
+        }
+        c->generateMesh(section, gatherBorders(c->x, section, c->z), *meshUploader);
+    }
+
+    // Synchronous remesh of every section of a chunk
+    void remeshChunk(Chunk* c) {
+        for (int section = 0; section < CHUNK_SECTIONS; section++) {
+            remeshSection(c, section);
+        }
+    }
+
+    // Queue a mesh job for one section of the chunk at (cx, cz), if it is loaded. The
+    // blocks are copied now; the faces are built on a worker and uploaded by
+    // uploadFinishedMeshes.
+    void requestMesh(int cx, int section, int cz) {
+        Chunk* c = findChunk(cx, cz);
+        if (!c) return;
+
+        if (!isSectionInRange(section) || isHiddenSection(c, section)) {
+            // Nothing to build, no job needed
+            c->clearMesh(section, *meshUploader);
+            return;
+        }
+
+        std::shared_ptr<MeshInput> input = std::make_shared<MeshInput>();
+        c->fillMeshInput(section, *input);
+        input->borders = gatherBorders(cx, section, cz);
+
+        uint32_t revision = ++c->jobs->meshRevision[section];
+        std::shared_ptr<Chunk::JobState> state = c->jobs;
+
+        workers.submit([this, input, revision, state] {
+            // Chunk unloaded, or a newer request came in before we started
+            if (state->cancelled || state->meshRevision[input->section] != revision) return;
+
+            Trace::nameThread("worker");
+            ProfileZone zone("mesh");
+            TraceSpan span("mesh", input->x, input->z, input->section);
+            MeshResult result;
+            result.x = input->x;
+            result.z = input->z;
+            result.section = input->section;
+            result.revision = revision;
+            Chunk::buildMesh(*input, result.vertices);
+            zone.end();
+            span.end();
+
+            std::lock_guard<std::mutex> lock(meshResultsMutex);
+            meshResults.push_back(std::move(result));
+        });
+    }
+
+    // Main thread half of meshing: upload up to maxMeshUploadsPerFrame finished meshes
+    void uploadFinishedMeshes() {
+        int uploads = 0;
+        while (uploads < maxMeshUploadsPerFrame) {
+            MeshResult result;
+            {
+                std::lock_guard<std::mutex> lock(meshResultsMutex);
+                if (meshResults.empty()) break;
+                result = std::move(meshResults.front());
+                meshResults.pop_front();
+            }
+
+            // Drop results for chunks that were unloaded or have been remeshed since
+            Chunk* c = findChunk(result.x, result.z);
+            if (!c) continue;
+            if (c->jobs->meshRevision[result.section] != result.revision) continue;
+
+            TraceSpan span("upload", result.x, result.z, result.section);
+            meshUploader->upload(c->meshes[result.section], result.vertices);
+            uploads++;
         }
     }
 
+    // Load/generate a chunk on a worker. It only enters activeChunks (and gets drawn)
+    // once update() picks it up from readyChunks.
+    void requestChunk(int cx, int cz) {
+        std::shared_ptr<std::atomic<bool>> cancelled = std::make_shared<std::atomic<bool>>(false);
+        pendingChunks.insert(cx, cz, cancelled);
+        Trace::asyncBegin("requested", cx, cz);
+
+        workers.submit([this, cx, cz, cancelled] {
+            if (*cancelled) return;
+            Trace::nameThread("worker");
+
+            Chunk* newChunk = new Chunk(cx, cz);
+
+            // TRY LOADING FROM FILE
+            ProfileZone zone("load");
+            TraceSpan span("load", cx, cz);
+            if (!loadChunk(newChunk)) {
+                // File didn't exist, so generate fresh terrain. Not saved until it is
+                // modified, the same seed generates it again next time.
+                zone.next("generate");
+                span.next("generate");
+                newChunk->generateBlocks();
+            }
+            zone.end();
+            span.end();
+
+            std::lock_guard<std::mutex> lock(readyChunksMutex);
+            readyChunks.push_back(newChunk);
+        });
+    }
+
+    // Jobs (chunk loads and meshes) not picked up by a worker yet
+    size_t queuedJobs() {
+        return workers.queuedJobs();
+    }
+
+    // Queue every modified chunk for saving, then wait until it's all on disk.
+    // Call before exiting.
+    void shutdown() {
+        saveAllChunks();
+        saveService.flush();
+    }
+
+    // Queues modified chunks for the I/O thread, doesn't wait for the writes
     void saveAllChunks() {
         //std::cout << "Saving " << activeChunks.size() << " chunks..." << std::endl;
-        for (auto& pair : activeChunks) {
-            saveChunk(pair.second);
+        for (auto& slot : activeChunks) {
+            saveChunk(slot.value);
         }
         //std::cout << "World saved." << std::endl;
     }
 
-    void update(glm::vec3 playerPos) {
+    // Rebuild every loaded chunk's mesh (e.g. after switching Chunk::meshingMode)
+    void remeshAll() {
+        for (auto& slot : activeChunks) {
+            remeshChunk(slot.value);
+        }
+    }
+
+    // Total number of vertices currently uploaded for all loaded chunks
+    long long totalVertexCount() {
+        long long total = 0;
+        for (auto& slot : activeChunks) {
+            total += slot.value->vertexCount();
+        }
+        return total;
+    }
+
+    // viewDir and velocity are optional, they only bias which chunks stream in first
+    void update(glm::vec3 playerPos, glm::vec3 viewDir = glm::vec3(0.0f), glm::vec3 velocity = glm::vec3(0.0f)) {
         int px = static_cast<int>(floor(playerPos.x / CHUNK_SIZE));
         int pz = static_cast<int>(floor(playerPos.z / CHUNK_SIZE));
 
-        // 1. Load/Generate new chunks
+        ProfileZone phase("request chunks");
+        setStreamingFocus(playerPos, viewDir, velocity);
+        updateVerticalRange();
+
+        // 1. Request missing chunks from the workers, closest/most relevant first
+        std::priority_queue<QueuedChunk, std::vector<QueuedChunk>, std::greater<QueuedChunk>> missing;
         for (int x = px - renderDistance; x <= px + renderDistance; x++) {
             for (int z = pz - renderDistance; z <= pz + renderDistance; z++) {
 
@@ -88,91 +391,334 @@ public:
                     if (x < WORLD_MIN_X || x >= WORLD_MAX_X || z < WORLD_MIN_Z || z >= WORLD_MAX_Z) continue;
                 }
 
-                // If chunk doesn't exist in memory, load or create it
-                if (activeChunks.find({ x, z }) == activeChunks.end()) {
-                    Chunk* newChunk = new Chunk(x, z);
+                // If chunk doesn't exist in memory and isn't on its way, load or create it
+                if (!activeChunks.contains(x, z) && !pendingChunks.contains(x, z)) {
+                    missing.push({ chunkPriority(x, z), x, z });
+                }
+            }
+        }
 
-                    // TRY LOADING FROM FILE
-                    if (loadChunk(newChunk)) {
-                        newChunk->generateMesh(); // Mesh only after loading data
-                    }
-                    else {
-                        // File didn't exist, so generate fresh terrain
-                        newChunk->generateBlocks();
-                        newChunk->generateMesh();
-                        // Optional: Save immediately so the file exists next time
-                        saveChunk(newChunk);
-                    }
+        int requested = 0;
+        while (!missing.empty() && requested < maxChunkRequestsPerFrame &&
+               pendingChunks.size() < (size_t)maxChunkRequestsInFlight) {
+            requestChunk(missing.top().x, missing.top().z);
+            missing.pop();
+            requested++;
+        }
 
-                    activeChunks[{x, z}] = newChunk;
-                }
+        // Forget requests that fell out of range before a worker got to them
+        std::vector<std::pair<int, int>> dropped;
+        for (auto& pending : pendingChunks) {
+            if (isOutOfRange(pending.x, pending.z, px, pz)) {
+                *pending.value = true;
+                dropped.push_back({ pending.x, pending.z });
+                Trace::asyncEnd("requested", pending.x, pending.z);
             }
         }
+        for (auto& pos : dropped) {
+            pendingChunks.erase(pos.first, pos.second);
+        }
+
+        // Take in the chunks the workers finished
+        phase.next("take in chunks");
+        std::deque<Chunk*> arrived;
+        {
+            std::lock_guard<std::mutex> lock(readyChunksMutex);
+            arrived.swap(readyChunks);
+        }
+        for (Chunk* newChunk : arrived) {
+            if (!pendingChunks.erase(newChunk->x, newChunk->z)) {
+                // Cancelled after the worker had already finished it
+                delete newChunk;
+                continue;
+            }
+
+            int x = newChunk->x;
+            int z = newChunk->z;
+            activeChunks.insert(x, z, newChunk);
+            Trace::asyncEnd("requested", x, z);
+            Trace::asyncBegin("resident", x, z);
+
+            // The new chunk and the neighbours it now covers need a mesh. Queued rather
+            // than requested right away, so a chunk whose neighbours arrive in the same
+            // frame is only meshed once.
+            queueColumnMeshes(x, z);
+            for (int side = 0; side < 4; side++) {
+                queueColumnMeshes(x + SIDE_OFFSETS[side][0], z + SIDE_OFFSETS[side][1]);
+            }
+        }
+
+        // Send the most urgent queued section meshes to the workers
+        phase.next("request meshes");
+        std::priority_queue<QueuedSection, std::vector<QueuedSection>, std::greater<QueuedSection>> toMesh;
+        for (auto queued = meshQueue.begin(); queued != meshQueue.end(); ) {
+            auto [x, section, z] = *queued;
+            if (!activeChunks.contains(x, z) || !isSectionInRange(section)) {
+                // Not loaded (or already unloaded), it gets queued again when it arrives
+                // or comes back into vertical range
+                queued = meshQueue.erase(queued);
+                continue;
+            }
+            toMesh.push({ chunkPriority(x, z) + abs(section - focusSection), x, section, z });
+            ++queued;
+        }
+        for (int i = 0; i < maxMeshRequestsPerFrame && !toMesh.empty(); i++) {
+            const QueuedSection& next = toMesh.top();
+            requestMesh(next.x, next.section, next.z);
+            meshQueue.erase({ next.x, next.section, next.z });
+            toMesh.pop();
+        }
 
         // 2. Unload far chunks
-        auto it = activeChunks.begin();
-        while (it != activeChunks.end()) {
-            int cx = it->second->x;
-            int cz = it->second->z;
-
-            if (abs(cx - px) > renderDistance + 1 || abs(cz - pz) > renderDistance + 1) {
-                // SAVE BEFORE DELETING
-                saveChunk(it->second);
-
-                it->second->del();
-                delete it->second;
-                it = activeChunks.erase(it);
+        // Neighbours are not remeshed here: their faces towards the unloaded chunk stay
+        // culled, but that edge is a full render distance away and hidden by fog.
+        phase.next("unload");
+        std::vector<Chunk*> farChunks;
+        for (auto& slot : activeChunks) {
+            if (isOutOfRange(slot.x, slot.z, px, pz)) {
+                farChunks.push_back(slot.value);
             }
-            else {
-                ++it;
+        }
+
+        for (Chunk* c : farChunks) {
+            TraceSpan span("unload", c->x, c->z);
+            Trace::asyncEnd("resident", c->x, c->z);
+
+            // SAVE BEFORE DELETING
+            saveChunk(c);
+
+            // Queued mesh jobs for it are skipped, finished ones are dropped on upload
+            c->jobs->cancelled = true;
+
+            activeChunks.erase(c->x, c->z);
+            c->del(*meshUploader);
+            delete c;
+        }
+
+        // 3. Upload meshes the workers finished
+        phase.next("upload meshes");
+        uploadFinishedMeshes();
+
+        // 4. Remesh what this frame's edits touched, so it shows up this frame
+        phase.next("remesh edits");
+        remeshDirtySections();
+
+        // 5. Hand this frame's edits to the save service
+        phase.next("save edits");
+        for (auto& pos : editedChunks) {
+            if (Chunk* c = findChunk(pos.first, pos.second)) {
+                saveChunk(c);
             }
         }
+        editedChunks.clear();
     }
 
-    void render(Shader& shader) {
-        for (auto& pair : activeChunks) {
-            pair.second->draw(shader);
+    // Calls visit(mesh, origin) for every section with a mesh inside the view frustum of
+    // viewProjection (projection * view); origin is the world position of the section's
+    // (0,0,0) corner. Fills renderStats. Drawing is up to the caller (WorldRenderer in
+    // world_renderer.hpp), this part needs no GPU.
+    template <typename Visit>
+    void forEachVisibleSection(const glm::mat4& viewProjection, Visit&& visit) {
+        Frustum frustum = Frustum::fromMatrix(viewProjection);
+        renderStats = RenderStats();
+
+        for (auto& slot : activeChunks) {
+            Chunk* c = slot.value;
+            for (int section = 0; section < CHUNK_SECTIONS; section++) {
+                const Chunk::SectionMesh& mesh = c->meshes[section];
+                if (mesh.indexCount == 0) continue; // Nothing to draw, not worth a test
+
+                glm::vec3 boxMin((float)(c->x * CHUNK_SIZE), (float)(section * CHUNK_SIZE), (float)(c->z * CHUNK_SIZE));
+                renderStats.tested++;
+                if (frustumCulling) {
+                    glm::vec3 boxMax = boxMin + glm::vec3((float)CHUNK_SIZE);
+                    if (!frustum.intersectsBox(boxMin, boxMax)) {
+                        renderStats.culled++;
+                        continue;
+                    }
+                }
+
+                visit(mesh, boxMin);
+                renderStats.drawn++;
+                if (!c->drawn) {
+                    c->drawn = true;
+                    Trace::instant("first drawn", c->x, c->z, section);
+                }
+            }
         }
     }
 
 private:
-    // Save chunk blocks to binary file
+    // A mesh built by a worker, waiting for the main thread to upload it
+    struct MeshResult {
+        int x = 0, z = 0;
+        int section = 0;
+        uint32_t revision = 0;
+        std::vector<ChunkVertex> vertices;
+    };
+
+    std::mutex meshResultsMutex;
+    std::deque<MeshResult> meshResults;
+
+    // A chunk waiting in one of the streaming queues, lowest priority value goes first
+    struct QueuedChunk {
+        float priority;
+        int x, z;
+        bool operator>(const QueuedChunk& other) const { return priority > other.priority; }
+    };
+
+    // Same for one section of a chunk
+    struct QueuedSection {
+        float priority;
+        int x, section, z;
+        bool operator>(const QueuedSection& other) const { return priority > other.priority; }
+    };
+
+    // Where the player is, looks and moves, as of the last update()
+    glm::vec3 focusPos = glm::vec3(0.0f);
+    glm::vec2 focusView = glm::vec2(0.0f);     // Normalized, XZ plane (zero if unknown)
+    glm::vec2 focusMovement = glm::vec2(0.0f); // Normalized, XZ plane (zero if standing still)
+    int focusSection = 0;                      // Section the player is in (clamped to the world)
+
+    void setStreamingFocus(glm::vec3 playerPos, glm::vec3 viewDir, glm::vec3 velocity) {
+        focusPos = playerPos;
+        focusSection = std::clamp((int)floor(playerPos.y / CHUNK_SIZE), 0, CHUNK_SECTIONS - 1);
+
+        glm::vec2 view(viewDir.x, viewDir.z);
+        focusView = glm::length(view) > 0.001f ? glm::normalize(view) : glm::vec2(0.0f);
+
+        // Ignore drifting, only count actual walking/flying
+        glm::vec2 movement(velocity.x, velocity.z);
+        focusMovement = glm::length(movement) > 0.5f ? glm::normalize(movement) : glm::vec2(0.0f);
+    }
+
+    // Lower = more urgent. Distance from the player in chunks, shrunk for chunks in
+    // front of the camera and along the direction the player is moving.
+    float chunkPriority(int cx, int cz) const {
+        glm::vec2 toChunk((cx + 0.5f) * CHUNK_SIZE - focusPos.x, (cz + 0.5f) * CHUNK_SIZE - focusPos.z);
+        float dist = glm::length(toChunk) / CHUNK_SIZE;
+
+        // The ground under (and right around) the player always comes first
+        if (dist < 1.5f) return dist;
+
+        glm::vec2 dir = toChunk / (dist * CHUNK_SIZE);
+        float scale = 1.0f;
+        scale -= viewPriorityWeight * std::max(0.0f, glm::dot(dir, focusView));
+        scale -= velocityPriorityWeight * std::max(0.0f, glm::dot(dir, focusMovement));
+        return dist * std::max(scale, 0.1f);
+    }
+
+    // Sections within verticalRenderDistance of focusSection get meshed
+    bool isSectionInRange(int section) const {
+        return abs(section - focusSection) <= verticalRenderDistance;
+    }
+
+    // Sections of loaded chunks waiting for a mesh job, as (x, section, z) (main thread only)
+    std::set<std::tuple<int, int, int>> meshQueue;
+
+    // Vertical section range the current meshes were built for
+    int meshedMinSection = 0, meshedMaxSection = -1;
+
+    void queueColumnMeshes(int cx, int cz) {
+        for (int section = 0; section < CHUNK_SECTIONS; section++) {
+            if (isSectionInRange(section)) meshQueue.insert({ cx, section, cz });
+        }
+    }
+
+    // When the player changes section, free the meshes that left the vertical range
+    // and queue the sections that came into it
+    void updateVerticalRange() {
+        int minSection = std::max(0, focusSection - verticalRenderDistance);
+        int maxSection = std::min(CHUNK_SECTIONS - 1, focusSection + verticalRenderDistance);
+        if (minSection == meshedMinSection && maxSection == meshedMaxSection) return;
+
+        for (auto& slot : activeChunks) {
+            for (int section = 0; section < CHUNK_SECTIONS; section++) {
+                bool wasInRange = section >= meshedMinSection && section <= meshedMaxSection;
+                bool inRange = section >= minSection && section <= maxSection;
+                if (wasInRange && !inRange) slot.value->clearMesh(section, *meshUploader);
+                if (!wasInRange && inRange) meshQueue.insert({ slot.x, section, slot.z });
+            }
+        }
+        meshedMinSection = minSection;
+        meshedMaxSection = maxSection;
+    }
+
+    // Chunks requested from the workers, with their cancel flag (main thread only)
+    ChunkMap<std::shared_ptr<std::atomic<bool>>> pendingChunks;
+
+    // Chunks the workers finished loading/generating
+    std::mutex readyChunksMutex;
+    std::deque<Chunk*> readyChunks;
+
+    // Chunks edited since the last update() (main thread only)
+    std::set<std::pair<int, int>> editedChunks;
+
+    // Sections (x, section, z) that need a remesh because of those edits
+    std::set<std::tuple<int, int, int>> dirtySections;
+
+    // Region files under saveFolder. Outlives the save service and the workers.
+    RegionStore regions{ saveFolder };
+
+    // Writes chunk files in the background. Destroyed after the workers (which read
+    // from it when loading) and flushes whatever is still queued.
+    ChunkSaveService saveService{ [this](int cx, int cz, const ChunkSaveService::Snapshot& data) {
+        writeChunkFile(cx, cz, data);
+    } };
+
+    // Shared by chunk loading and meshing. Declared last so it is destroyed first:
+    // no job can outlive the queues above.
+    ThreadPool workers;
+
+    // Chunks this far from the player's chunk get unloaded
+    bool isOutOfRange(int cx, int cz, int px, int pz) const {
+        return abs(cx - px) > renderDistance + 1 || abs(cz - pz) > renderDistance + 1;
+    }
+
+    // Queue a snapshot of the chunk's blocks for the I/O thread
     void saveChunk(Chunk* c) {
         if (!c->isModified) return;
 
-        std::string filename = saveFolder + "chunk_" + std::to_string(c->x) + "_" + std::to_string(c->z) + ".bin";
-        std::ofstream out(filename, std::ios::binary);
-        if (out.is_open()) {
-            out.write((char*)&c->blocks, sizeof(c->blocks));
-            out.close();
+        ChunkSaveService::Snapshot data((size_t)CHUNK_SECTIONS * BlockStorage::VOLUME);
+        c->copyBlocks(data.data());
+        saveService.queue(c->x, c->z, std::move(data));
 
-            // Reset flag after successful save
-            c->isModified = false;
+        // The service owns the data now and writes it even if the chunk is unloaded
+        c->isModified = false;
+    }
+
+    // Runs on the save service's I/O thread, so compressing costs the main thread nothing
+    void writeChunkFile(int cx, int cz, const ChunkSaveService::Snapshot& data) {
+        static_assert(BlockStorage::VOLUME == CHUNK_CODEC_VOLUME, "codec expects 16^3 blocks");
+        Trace::nameThread("save I/O");
+        ProfileZone zone("save");
+        TraceSpan span("save", cx, cz);
+        std::vector<uint8_t> encoded;
+        encodeColumn(data.data(), CHUNK_SECTIONS, encoded);
+        if (!regions.write(cx, cz, encoded.data(), encoded.size())) {
+            std::cerr << "Failed to save chunk " << cx << ", " << cz << std::endl;
         }
     }
 
-    // Load chunk blocks from binary file
+    // Load chunk blocks from its region file (runs on a worker)
     bool loadChunk(Chunk* c) {
-        std::string filename = saveFolder + "chunk_" + std::to_string(c->x) + "_" + std::to_string(c->z) + ".bin";
-        std::ifstream in(filename, std::ios::binary | std::ios::ate); // Open at the end to check size
-
-        if (in.is_open()) {
-            // Check file size
-            std::streamsize fileSize = in.tellg();
-            std::streamsize expectedSize = sizeof(c->blocks);
-
-            if (fileSize != expectedSize) {
-                // The file is the wrong size (old version?), so we reject it
-                in.close();
-                return false;
-            }
-
-            // Go back to start and read
-            in.seekg(0, std::ios::beg);
-            in.read((char*)&c->blocks, expectedSize);
-            in.close();
+        // A save still waiting for the I/O thread is newer than the file
+        ChunkSaveService::Snapshot pendingSave;
+        if (saveService.getPending(c->x, c->z, pendingSave) && pendingSave.size() == (size_t)CHUNK_SECTIONS * BlockStorage::VOLUME) {
+            c->loadBlocks(pendingSave.data());
             return true;
         }
-        return false;
+
+        std::vector<uint8_t> data;
+        if (!regions.read(c->x, c->z, data)) return false;
+
+        std::vector<uint8_t> decoded((size_t)CHUNK_SECTIONS * CHUNK_CODEC_VOLUME);
+        if (!decodeColumn(data.data(), data.size(), decoded.data(), CHUNK_SECTIONS)) {
+            // Corrupt or from a newer version, so we reject it
+            std::cerr << "Bad chunk data " << c->x << ", " << c->z << std::endl;
+            return false;
+        }
+        c->loadBlocks(decoded.data());
+        return true;
     }
 };
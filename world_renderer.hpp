@@ -0,0 +1,262 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <bit>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "world.hpp"
+#include "range_allocator.hpp"
+
+// The GL layer over World: section meshes live in one big vertex buffer (VertexArena),
+// ArenaMeshUploader puts them there, WorldRenderer draws what's visible. Everything
+// here is main thread only and needs a current GL context.
+
+// Element buffer shared by every chunk. Quads are stored as 4 vertices and quad q
+// is drawn as triangles (4q+0, 4q+1, 4q+2) and (4q+2, 4q+3, 4q+0). Built once for
+// the largest possible section, so any section mesh can be drawn with it.
+struct QuadIndexBuffer {
+    static inline unsigned int EBO = 0;
+
+    // Creates the buffer on first use (needs a current GL context)
+    static unsigned int get() {
+        if (EBO == 0) {
+            std::vector<uint16_t> indices;
+            indices.reserve(MAX_CHUNK_QUADS * 6);
+            for (int q = 0; q < MAX_CHUNK_QUADS; q++) {
+                uint16_t base = (uint16_t)(q * 4);
+                indices.insert(indices.end(), { base, (uint16_t)(base + 1), (uint16_t)(base + 2),
+                                                (uint16_t)(base + 2), (uint16_t)(base + 3), base });
+            }
+
+            glGenBuffers(1, &EBO);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint16_t), indices.data(), GL_STATIC_DRAW);
+        }
+        return EBO;
+    }
+};
+
+// Layout of one command in the GL_DRAW_INDIRECT_BUFFER for glMultiDrawElementsIndirect
+struct DrawElementsIndirectCommand {
+    uint32_t count;         // Indices
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t baseVertex;     // Added to every index: where the mesh starts in the arena
+    uint32_t baseInstance;
+};
+
+// Shader storage binding of the per-draw section origins (see shaders/vertex.glsl)
+const int SECTION_ORIGINS_BINDING = 0;
+
+// One vertex buffer holding the meshes of every section, so everything visible is
+// drawn with a single glMultiDrawElementsIndirect. Sections own ranges of it, handed
+// out by a RangeAllocator. Range sizes are powers of two (at least MIN_RANGE vertices):
+// that keeps the free list from splintering, and gives a growing mesh some room before
+// it has to move. When nothing fits the buffer doubles, copying its contents over on
+// the GPU. Quads are drawn through QuadIndexBuffer with baseVertex = range start.
+// Main thread only.
+struct VertexArena {
+    static const uint32_t MIN_RANGE = 256;
+    static const uint32_t MAX_RANGE = MAX_CHUNK_QUADS * 4;
+    static const uint32_t INITIAL_SIZE = 1 << 20; // Vertices, 8 MB
+
+    static inline unsigned int VAO = 0, VBO = 0;
+    static inline RangeAllocator ranges;
+
+    // Range size that holds `vertices`
+    static uint32_t rangeFor(int vertices) {
+        return std::min(MAX_RANGE, std::bit_ceil((uint32_t)std::max(vertices, (int)MIN_RANGE)));
+    }
+
+    // Start of a free range of `count` vertices, growing the buffer if needed
+    static uint32_t allocate(uint32_t count) {
+        if (VAO == 0) resize(INITIAL_SIZE);
+        uint32_t first = ranges.allocate(count);
+        if (first == RangeAllocator::INVALID) {
+            // Enough to take it at the end, whatever is free there already
+            uint32_t size = ranges.size();
+            while (size - ranges.size() + ranges.freeTail() < count) size *= 2;
+            resize(size);
+            first = ranges.allocate(count);
+        }
+        return first;
+    }
+
+    static void free(uint32_t first, uint32_t count) {
+        ranges.free(first, count);
+    }
+
+    static void write(uint32_t first, const ChunkVertex* vertices, size_t count) {
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)first * sizeof(ChunkVertex), count * sizeof(ChunkVertex), vertices);
+    }
+
+    // Draws the given commands, origins[i] is the world position of command i's section
+    static void draw(const std::vector<DrawElementsIndirectCommand>& commands, const std::vector<glm::vec4>& origins) {
+        if (commands.empty()) return;
+        if (commandBuffer == 0) {
+            glGenBuffers(1, &commandBuffer);
+            glGenBuffers(1, &originBuffer);
+        }
+
+        // Both rewritten every frame, orphaned so the upload doesn't wait on last frame's draw
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, originBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, origins.size() * sizeof(glm::vec4), origins.data(), GL_STREAM_DRAW);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SECTION_ORIGINS_BINDING, originBuffer);
+
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data(), GL_STREAM_DRAW);
+
+        glBindVertexArray(VAO);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_SHORT, nullptr, (GLsizei)commands.size(), 0);
+    }
+
+private:
+    static inline unsigned int commandBuffer = 0, originBuffer = 0;
+
+    // (Re)creates the buffer with room for `size` vertices, keeping the contents
+    static void resize(uint32_t size) {
+        unsigned int newVBO;
+        glGenBuffers(1, &newVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, newVBO);
+        glBufferData(GL_ARRAY_BUFFER, (size_t)size * sizeof(ChunkVertex), nullptr, GL_DYNAMIC_DRAW);
+
+        if (VBO != 0) {
+            glBindBuffer(GL_COPY_READ_BUFFER, VBO);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_ARRAY_BUFFER, 0, 0, (size_t)ranges.size() * sizeof(ChunkVertex));
+            glDeleteBuffers(1, &VBO);
+        }
+        else {
+            glGenVertexArrays(1, &VAO);
+        }
+        VBO = newVBO;
+        ranges.grow(size);
+
+        // Attributes point at the buffer bound when they're set, so set them again
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        // The element buffer binding is part of the VAO state
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, QuadIndexBuffer::get());
+
+        // Local position + face (4 x uint8)
+        glVertexAttribIPointer(0, 4, GL_UNSIGNED_BYTE, sizeof(ChunkVertex), (void*)0);
+        glEnableVertexAttribArray(0);
+        // Texture layer (uint16)
+        glVertexAttribIPointer(1, 1, GL_UNSIGNED_SHORT, sizeof(ChunkVertex), (void*)offsetof(ChunkVertex, layer));
+        glEnableVertexAttribArray(1);
+    }
+};
+
+// Keeps World's section meshes in the VertexArena. A section keeps its arena range
+// as long as the mesh fits it, and moves to another one when it doesn't (or when the
+// mesh shrank to a fraction of it).
+class ArenaMeshUploader : public MeshUploader {
+public:
+    void upload(Chunk::SectionMesh& mesh, const std::vector<ChunkVertex>& vertices) override {
+        std::vector<uint64_t>().swap(mesh.uploadedQuads);
+        mesh.vertexCount = (int)vertices.size();
+        mesh.indexCount = mesh.vertexCount / 4 * 6;
+        if (vertices.empty()) {
+            releaseRange(mesh); // Nothing visible, no space needed
+            return;
+        }
+
+        uint32_t needed = VertexArena::rangeFor(mesh.vertexCount);
+        if (mesh.capacity != needed && ((uint32_t)mesh.vertexCount > mesh.capacity || (uint32_t)mesh.vertexCount * 4 < mesh.capacity)) {
+            releaseRange(mesh);
+            mesh.first = VertexArena::allocate(needed);
+            mesh.capacity = needed;
+        }
+        VertexArena::write(mesh.first, vertices.data(), vertices.size());
+    }
+
+    // Replaces the mesh in place when the new one fits the section's arena range. An
+    // edit only changes a few quads, and the meshers emit quads in a fixed order, so
+    // only the quads between the first and the last one that differ from the previous
+    // upload are sent with glBufferSubData. The section is still remeshed as a whole;
+    // this only narrows the upload. Quads are compared by hash, so an edited section
+    // keeps a quarter of its vertex size on the CPU instead of a full copy.
+    void patch(Chunk::SectionMesh& mesh, std::vector<ChunkVertex>&& vertices) override {
+        std::vector<uint64_t> hashes = hashQuads(vertices);
+        if (mesh.capacity == 0 || vertices.empty() || vertices.size() > (size_t)mesh.capacity) {
+            upload(mesh, vertices);
+            if (!vertices.empty()) mesh.uploadedQuads = std::move(hashes);
+            return;
+        }
+
+        // Without the hashes of the last upload (meshed on a worker) everything is sent once
+        size_t first = 0, end = hashes.size();
+        const std::vector<uint64_t>& old = mesh.uploadedQuads;
+        if (!old.empty()) {
+            size_t common = std::min(old.size(), hashes.size());
+            while (first < common && old[first] == hashes[first]) first++;
+            // Past a change in length everything after it moved, so only trim the end
+            // when the length stayed the same
+            if (old.size() == hashes.size()) {
+                while (end > first && old[end - 1] == hashes[end - 1]) end--;
+            }
+        }
+
+        if (end > first) {
+            VertexArena::write(mesh.first + (uint32_t)first * 4, vertices.data() + first * 4, (end - first) * 4);
+        }
+        mesh.vertexCount = (int)vertices.size();
+        mesh.indexCount = mesh.vertexCount / 4 * 6;
+        mesh.uploadedQuads = std::move(hashes);
+    }
+
+    void release(Chunk::SectionMesh& mesh) override {
+        releaseRange(mesh);
+        mesh = Chunk::SectionMesh();
+    }
+
+private:
+    // 64-bit hash of each quad's 4 vertices (32 bytes, read as 4 words)
+    static std::vector<uint64_t> hashQuads(const std::vector<ChunkVertex>& vertices) {
+        std::vector<uint64_t> hashes(vertices.size() / 4);
+        for (size_t quad = 0; quad < hashes.size(); quad++) {
+            uint64_t h = 0x9E3779B97F4A7C15ull;
+            for (int v = 0; v < 4; v++) {
+                uint64_t word;
+                memcpy(&word, &vertices[quad * 4 + v], sizeof(word));
+                h = (h ^ word) * 0xFF51AFD7ED558CCDull;
+                h ^= h >> 32;
+            }
+            hashes[quad] = h;
+        }
+        return hashes;
+    }
+
+    // Hands a section's arena range back
+    static void releaseRange(Chunk::SectionMesh& mesh) {
+        if (mesh.capacity == 0) return;
+        VertexArena::free(mesh.first, mesh.capacity);
+        mesh.capacity = 0;
+    }
+};
+
+// Draws the sections of a World (meshed through ArenaMeshUploader) that are inside the
+// view frustum, all with one indirect multi-draw. The shader finds each section's
+// origin through gl_DrawID.
+class WorldRenderer {
+public:
+    void render(World& world, const glm::mat4& viewProjection) {
+        drawCommands.clear();
+        drawOrigins.clear();
+        world.forEachVisibleSection(viewProjection, [this](const Chunk::SectionMesh& mesh, glm::vec3 origin) {
+            drawCommands.push_back({ (uint32_t)mesh.indexCount, 1, 0, (int32_t)mesh.first, 0 });
+            drawOrigins.push_back(glm::vec4(origin, 0.0f));
+        });
+        VertexArena::draw(drawCommands, drawOrigins);
+    }
+
+private:
+    // Built every frame, kept to reuse the memory
+    std::vector<DrawElementsIndirectCommand> drawCommands;
+    std::vector<glm::vec4> drawOrigins;
+};